@@ -0,0 +1,68 @@
+#include <c12cxx/c12cxx.h>
+#include <c12cxx/details/api/types.h>
+
+#include "test_utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::size_t kBlobSize = 100 * 1024 * 1024;
+
+class BenchComponent final: public c12cxx::Component {
+public:
+    std::u16string componentName() final { return u"BenchComponent"; }
+};
+
+template<typename Bytes>
+std::uint32_t checksum(Bytes const& bytes)
+{
+    std::uint32_t sum = 0;
+    for (auto byte: bytes)
+        sum = sum * 31 + static_cast<std::uint8_t>(byte);
+    return sum;
+}
+
+template<typename Handler>
+void runChecksum(benchmark::State& state, Handler handler)
+{
+    TestMemoryManager mem;
+    BenchComponent component;
+    component.setMemManager(&mem);
+    component.addMethod(u"Checksum", u"КонтрольнаяСумма").withHandler(handler);
+    const long methodNo = component.FindMethod(reinterpret_cast<const WCHAR_T*>(u"Checksum"));
+
+    std::vector<char> blob(kBlobSize, 'x');
+    tVariant param;
+    tVarInit(&param);
+    TV_VT(&param) = VTYPE_BLOB;
+    param.pstrVal = blob.data();
+    param.strLen = blob.size();
+    tVariant ret;
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(component.CallAsFunc(methodNo, &ret, &param, 1));
+        benchmark::DoNotOptimize(ret.lVal);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * kBlobSize);
+}
+
+// The handler gets a copy of the blob.
+void BM_BlobChecksum_vector(benchmark::State& state)
+{
+    runChecksum(state, [](std::vector<char> const& blob) { return static_cast<int>(checksum(blob)); });
+}
+BENCHMARK(BM_BlobChecksum_vector)->Unit(benchmark::kMillisecond);
+
+// The handler reads the host buffer through a BlobView.
+void BM_BlobChecksum_view(benchmark::State& state)
+{
+    runChecksum(state, [](c12cxx::BlobView blob) { return static_cast<int>(checksum(blob)); });
+}
+BENCHMARK(BM_BlobChecksum_view)->Unit(benchmark::kMillisecond);
+
+} // namespace
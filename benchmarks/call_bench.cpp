@@ -0,0 +1,93 @@
+#include <c12cxx/c12cxx.h>
+#include <c12cxx/details/MethodWrapper.h>
+#include <c12cxx/details/ParamSpan.h>
+#include <c12cxx/details/ValueAccessor.h>
+#include <c12cxx/details/api/types.h>
+
+#include "test_utils.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+class BenchComponent final: public c12cxx::Component {
+public:
+    std::u16string componentName() final { return u"BenchComponent"; }
+};
+
+int sum(int a, int b, int c)
+{
+    return a + b + c;
+}
+
+void fillParams(tVariant (&params)[3])
+{
+    for (int i = 0; i < 3; ++i) {
+        tVarInit(&params[i]);
+        TV_VT(&params[i]) = VTYPE_I4;
+        params[i].lVal = i + 1;
+    }
+}
+
+// Full CallAsFunc path: the parameters are passed to the handler through a ParamSpan over the host array.
+void BM_CallAsFunc(benchmark::State& state)
+{
+    TestMemoryManager mem;
+    BenchComponent component;
+    component.setMemManager(&mem);
+    component.addMethod(u"Sum", u"Сумма").withHandler(sum);
+    const long methodNo = component.FindMethod(reinterpret_cast<const WCHAR_T*>(u"Sum"));
+
+    tVariant params[3];
+    fillParams(params);
+    tVariant ret;
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(component.CallAsFunc(methodNo, &ret, params, 3));
+        benchmark::DoNotOptimize(ret.lVal);
+    }
+}
+BENCHMARK(BM_CallAsFunc);
+
+// The wrapper call alone with the parameters collected into a std::vector, as CallAsFunc used to do.
+void BM_MethodWrapper_vector(benchmark::State& state)
+{
+    TestMemoryManager mem;
+    c12cxx::MethodWrapper wrapper(sum);
+
+    tVariant params[3];
+    fillParams(params);
+    tVariant ret;
+
+    for (auto _: state) {
+        std::vector<c12cxx::ValueAccessor> accessors;
+        accessors.reserve(3);
+        for (auto& param: params)
+            accessors.emplace_back(&param, &mem);
+        benchmark::DoNotOptimize(wrapper(c12cxx::ValueAccessor(&ret, &mem), accessors));
+        benchmark::DoNotOptimize(ret.lVal);
+    }
+}
+BENCHMARK(BM_MethodWrapper_vector);
+
+// The same call through a ParamSpan.
+void BM_MethodWrapper_span(benchmark::State& state)
+{
+    TestMemoryManager mem;
+    c12cxx::MethodWrapper wrapper(sum);
+
+    tVariant params[3];
+    fillParams(params);
+    tVariant ret;
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(wrapper(c12cxx::ValueAccessor(&ret, &mem), c12cxx::ParamSpan(params, 3, &mem)));
+        benchmark::DoNotOptimize(ret.lVal);
+    }
+}
+BENCHMARK(BM_MethodWrapper_span);
+
+} // namespace
@@ -0,0 +1,138 @@
+#include <c12cxx/c12cxx.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+std::size_t allocatedBytes = 0;
+std::size_t allocationCount = 0;
+
+void* countedAlloc(std::size_t size)
+{
+    allocatedBytes += size;
+    ++allocationCount;
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+// Replacements of the global allocation functions for the whole benchmark binary, used to report the heap
+// footprint of a component instance.
+void* operator new(std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+
+constexpr std::size_t kMembers = 50;
+
+std::u16string numbered(std::u16string const& prefix, std::size_t no)
+{
+    auto suffix = std::to_string(no);
+    return prefix + std::u16string(suffix.begin(), suffix.end());
+}
+
+// Registers its members in the constructor, once per instance.
+class RuntimeComponent final: public c12cxx::Component {
+public:
+    RuntimeComponent()
+    {
+        for (std::size_t i = 0; i < kMembers; ++i) {
+            addProperty(numbered(u"OrderProperty", i), numbered(u"СвойствоЗаказа", i))
+                .withGetter(*this, &RuntimeComponent::value);
+            addMethod(numbered(u"ProcessOrderLine", i), numbered(u"ОбработатьСтрокуЗаказа", i))
+                .withHandler(*this, &RuntimeComponent::process);
+        }
+    }
+
+    std::u16string componentName() final { return u"RuntimeComponent"; }
+
+    int value() { return value_; }
+
+    int process(int step) { return value_ += step; }
+
+private:
+    int value_{};
+};
+
+// Describes the same members once per type.
+class DescribedComponent final: public c12cxx::TypedComponent<DescribedComponent> {
+public:
+    static void describe(c12cxx::MemberTable& members)
+    {
+        for (std::size_t i = 0; i < kMembers; ++i) {
+            members.addProperty(numbered(u"OrderProperty", i), numbered(u"СвойствоЗаказа", i))
+                .withGetter(&DescribedComponent::value);
+            members.addMethod(numbered(u"ProcessOrderLine", i), numbered(u"ОбработатьСтрокуЗаказа", i))
+                .withHandler(&DescribedComponent::process);
+        }
+    }
+
+    std::u16string componentName() final { return u"DescribedComponent"; }
+
+    int value() { return value_; }
+
+    int process(int step) { return value_ += step; }
+
+private:
+    int value_{};
+};
+
+template<typename T>
+void BM_Construct(benchmark::State& state)
+{
+    // Built outside of the measured loop, the same way the per-type table outlives the first session.
+    std::make_unique<T>();
+
+    const std::size_t bytesBefore = allocatedBytes;
+    const std::size_t countBefore = allocationCount;
+
+    for (auto _: state) {
+        auto component = std::make_unique<T>();
+        benchmark::DoNotOptimize(component.get());
+    }
+
+    const auto iterations = static_cast<double>(state.iterations());
+    state.counters["heap_bytes"] = static_cast<double>(allocatedBytes - bytesBefore) / iterations;
+    state.counters["allocations"] = static_cast<double>(allocationCount - countBefore) / iterations;
+}
+BENCHMARK_TEMPLATE(BM_Construct, RuntimeComponent);
+BENCHMARK_TEMPLATE(BM_Construct, DescribedComponent);
+
+} // namespace
@@ -0,0 +1,61 @@
+#include <c12cxx/c12cxx.h>
+#include <c12cxx/details/api/types.h>
+
+#include "test_utils.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+class BenchComponent final: public c12cxx::Component {
+public:
+    std::u16string componentName() final { return u"BenchComponent"; }
+};
+
+std::u16string numbered(std::u16string const& prefix, std::size_t no)
+{
+    auto suffix = std::to_string(no);
+    return prefix + std::u16string(suffix.begin(), suffix.end());
+}
+
+// Resolves every registered name in turn, so the result is the mean cost over the whole table rather than
+// the cost of a lucky first entry.
+void BM_FindMethod(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+
+    BenchComponent component;
+    std::vector<std::u16string> names;
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back(numbered(u"ОбработатьСтрокуЗаказа", i));
+        component.addMethod(numbered(u"ProcessOrderLine", i), names.back());
+    }
+
+    std::size_t i = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(component.FindMethod(reinterpret_cast<const WCHAR_T*>(names[i].c_str())));
+        if (++i == count)
+            i = 0;
+    }
+}
+BENCHMARK(BM_FindMethod)->Arg(5)->Arg(50)->Arg(150)->Arg(500);
+
+void BM_FindProp_unknown(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+
+    BenchComponent component;
+    for (std::size_t i = 0; i < count; ++i)
+        component.addProperty(numbered(u"OrderProperty", i), numbered(u"СвойствоЗаказа", i));
+
+    const std::u16string unknown{u"НеизвестноеСвойство"};
+    for (auto _: state)
+        benchmark::DoNotOptimize(component.FindProp(reinterpret_cast<const WCHAR_T*>(unknown.c_str())));
+}
+BENCHMARK(BM_FindProp_unknown)->Arg(5)->Arg(50)->Arg(150)->Arg(500);
+
+} // namespace
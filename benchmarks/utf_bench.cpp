@@ -0,0 +1,136 @@
+#include <c12cxx/details/ValueAccessor.h>
+#include <c12cxx/details/utfutils.h>
+
+#include "test_utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "utf8.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::size_t kCorpusSize = 1024 * 1024;
+
+// A Russian paragraph of the kind found in messages and documents: Cyrillic words with ASCII spaces, digits and
+// punctuation.
+constexpr char kRussian[] =
+    "Документ № 1234 от 15.03.2024 проведён успешно. Контрагент: ООО \"Ромашка\", ИНН 7701234567. "
+    "Сумма документа составляет 125 000,00 руб., в том числе НДС 20% — 20 833,33 руб. "
+    "Склад отгрузки: Основной склад, ответственный — Иванов Иван Иванович. ";
+
+constexpr char kAscii[] =
+    "Document #1234 of 2024-03-15 has been posted. Counterparty: Romashka LLC, TIN 7701234567. "
+    "Total amount is 125000.00 RUB including VAT 20% of 20833.33 RUB. ";
+
+std::string makeCorpus(char const* paragraph)
+{
+    std::string corpus;
+    while (corpus.size() < kCorpusSize)
+        corpus += paragraph;
+    return corpus;
+}
+
+void toUtf16(benchmark::State& state, char const* paragraph)
+{
+    const std::string corpus = makeCorpus(paragraph);
+    for (auto _: state)
+        benchmark::DoNotOptimize(c12cxx::toUtf16(corpus));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+// Reference: the utf8cpp conversion used before, one code point per iteration appended to the result.
+void toUtf16_utf8cpp(benchmark::State& state, char const* paragraph)
+{
+    const std::string corpus = makeCorpus(paragraph);
+    for (auto _: state) {
+        std::u16string result;
+        utf8::utf8to16(corpus.begin(), corpus.end(), std::back_inserter(result));
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+void toUtf8(benchmark::State& state, char const* paragraph)
+{
+    const std::u16string corpus = c12cxx::toUtf16(makeCorpus(paragraph));
+    for (auto _: state)
+        benchmark::DoNotOptimize(c12cxx::toUtf8(corpus));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size() * sizeof(char16_t)));
+}
+
+void toUtf8_utf8cpp(benchmark::State& state, char const* paragraph)
+{
+    const std::u16string corpus = c12cxx::toUtf16(makeCorpus(paragraph));
+    for (auto _: state) {
+        std::string result;
+        utf8::utf16to8(corpus.begin(), corpus.end(), std::back_inserter(result));
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size() * sizeof(char16_t)));
+}
+
+void isValidUtf8(benchmark::State& state, char const* paragraph)
+{
+    const std::string corpus = makeCorpus(paragraph);
+    for (auto _: state)
+        benchmark::DoNotOptimize(c12cxx::isValidUtf8(corpus));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+void isValidUtf8_utf8cpp(benchmark::State& state, char const* paragraph)
+{
+    const std::string corpus = makeCorpus(paragraph);
+    for (auto _: state)
+        benchmark::DoNotOptimize(utf8::is_valid(corpus.begin(), corpus.end()));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+// A std::string result returned to the host as VTYPE_PWSTR: transcoded into host memory at once, or through an
+// intermediate std::u16string copied afterwards.
+void setUtf8AsWide(benchmark::State& state, char const* paragraph)
+{
+    const std::string corpus = makeCorpus(paragraph);
+    TestMemoryManager mem;
+    tVariant var;
+    for (auto _: state) {
+        c12cxx::ValueAccessor(&var, &mem).setUtf8AsWide(corpus);
+        benchmark::DoNotOptimize(var.pwstrVal);
+        mem.Clear();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+void setValue_toUtf16(benchmark::State& state, char const* paragraph)
+{
+    const std::string corpus = makeCorpus(paragraph);
+    TestMemoryManager mem;
+    tVariant var;
+    for (auto _: state) {
+        c12cxx::ValueAccessor(&var, &mem).setValue(std::u16string_view{c12cxx::toUtf16(corpus)});
+        benchmark::DoNotOptimize(var.pwstrVal);
+        mem.Clear();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(toUtf16, russian, kRussian);
+BENCHMARK_CAPTURE(toUtf16_utf8cpp, russian, kRussian);
+BENCHMARK_CAPTURE(toUtf16, ascii, kAscii);
+BENCHMARK_CAPTURE(toUtf16_utf8cpp, ascii, kAscii);
+BENCHMARK_CAPTURE(toUtf8, russian, kRussian);
+BENCHMARK_CAPTURE(toUtf8_utf8cpp, russian, kRussian);
+BENCHMARK_CAPTURE(toUtf8, ascii, kAscii);
+BENCHMARK_CAPTURE(toUtf8_utf8cpp, ascii, kAscii);
+BENCHMARK_CAPTURE(isValidUtf8, russian, kRussian);
+BENCHMARK_CAPTURE(isValidUtf8_utf8cpp, russian, kRussian);
+BENCHMARK_CAPTURE(isValidUtf8, ascii, kAscii);
+BENCHMARK_CAPTURE(isValidUtf8_utf8cpp, ascii, kAscii);
+BENCHMARK_CAPTURE(setUtf8AsWide, russian, kRussian);
+BENCHMARK_CAPTURE(setValue_toUtf16, russian, kRussian);
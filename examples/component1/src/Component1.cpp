@@ -1,12 +1,15 @@
 #include <c12cxx/c12cxx.h>
 #include <string>
 
-class Component1: public c12cxx::Component {
+class Component1: public c12cxx::TypedComponent<Component1> {
 public:
     static constexpr char16_t kComponentName[] = u"Component1";
     std::u16string componentName() final { return kComponentName; };
 
-    Component1() { addMethod(u"Ping", u"Пинг").withHandler(*this, &Component1::Ping); }
+    static void describe(c12cxx::MemberTable& members)
+    {
+        members.addMethod(u"Ping", u"Пинг").withHandler(&Component1::Ping);
+    }
 
 private:
     std::u16string str_;
@@ -17,4 +20,4 @@ private:
     }
 };
 
-REGISTER_COMPONENT(Component1)
\ No newline at end of file
+REGISTER_COMPONENT(Component1)
@@ -0,0 +1,106 @@
+#ifndef C12CXX_DETAILS_BATCH_H
+#define C12CXX_DETAILS_BATCH_H
+
+#include <c12cxx/details/api/IMemoryManager.h>
+#include <c12cxx/details/api/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace c12cxx {
+
+// Binary format of the built-in CallBatch method; all numbers are little-endian.
+//
+//     batch    := count:u32 call*count
+//     call     := method:value argc:u32 value*argc
+//     result   := count:u32 (status:u8 value)*count
+//     value    := vt:u16 payload
+//
+// A method is referenced by its number (VTYPE_I4) or by its name (VTYPE_PWSTR). Status 1 is followed by the return
+// value (VTYPE_EMPTY for procedures), status 0 by the error message (VTYPE_PWSTR). Supported payloads:
+//
+//     VTYPE_EMPTY, VTYPE_NULL    none
+//     VTYPE_BOOL                 u8
+//     VTYPE_I1, VTYPE_UI1        i8, u8
+//     VTYPE_I2, VTYPE_UI2        i16, u16
+//     VTYPE_I4, VTYPE_UI4        i32, u32 (VTYPE_INT, VTYPE_UINT and VTYPE_ERROR likewise)
+//     VTYPE_I8, VTYPE_UI8        i64, u64
+//     VTYPE_R4, VTYPE_R8         f32, f64
+//     VTYPE_DATE                 f64
+//     VTYPE_TM                   year:i32 month:i32 day:i32 hour:i32 minute:i32 second:i32
+//     VTYPE_PWSTR                length:u32 UTF-16 code units*length
+//     VTYPE_PSTR, VTYPE_BLOB     length:u32 bytes*length
+
+class BatchWriter {
+public:
+    static bool supports(TYPEVAR vt) noexcept;
+
+    void writeCount(std::uint32_t count);
+
+    void writeStatus(bool success);
+
+    // Throws std::invalid_argument for a type the format does not support.
+    void writeValue(tVariant const& value);
+
+    void writeEmpty();
+
+    void writeBool(bool value);
+
+    void writeInt(std::int32_t value);
+
+    void writeDouble(double value);
+
+    void writeString(std::u16string_view value);
+
+    void writeString(std::string_view value);
+
+    void writeBlob(std::string_view value);
+
+    std::vector<char> const& data() const noexcept { return data_; }
+
+private:
+    std::vector<char> data_;
+
+    void writeType(TYPEVAR vt);
+    void writeBytes(void const* bytes, std::size_t size);
+    void writeNumber(void const* number, std::size_t size);
+    void writeLength(std::size_t size);
+};
+
+class BatchReader {
+public:
+    BatchReader(char const* begin, char const* end) noexcept: pos_(begin), end_(end) { }
+
+    bool atEnd() const noexcept { return pos_ == end_; }
+
+    // Upper bound on the number of values left, each taking at least its type.
+    std::size_t maxValuesLeft() const noexcept
+    {
+        return static_cast<std::size_t>(end_ - pos_) / sizeof(std::uint16_t);
+    }
+
+    std::uint32_t readCount();
+
+    bool readStatus();
+
+    // Decodes a value into var; strings and blobs are allocated with the memory manager like the host does.
+    // Throws std::runtime_error if the data is malformed.
+    void readValue(tVariant& var, IMemoryManager* memoryManager);
+
+private:
+    char const* pos_;
+    char const* end_;
+
+    void readBytes(void* bytes, std::size_t size);
+    void readNumber(void* number, std::size_t size);
+    void const* skipBytes(std::size_t size);
+};
+
+// Releases memory held by a string or blob variant and resets it to VTYPE_EMPTY.
+void freeVariant(tVariant& var, IMemoryManager* memoryManager) noexcept;
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_BATCH_H
@@ -0,0 +1,53 @@
+#ifndef C12CXX_DETAILS_CASEFOLDING_H
+#define C12CXX_DETAILS_CASEFOLDING_H
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace c12cxx {
+
+// Simple (one to one) case folding for the scripts 1C identifiers are written in: Latin, Latin-1 and Cyrillic,
+// including Ё/ё and the rest of U+0400..U+040F. Every range maps to its lower case counterpart by a fixed offset.
+struct FoldRange {
+    char16_t first;
+    char16_t last;
+    char16_t delta;
+};
+
+inline constexpr FoldRange kFoldRanges[] = {
+    {0x0041, 0x005A, 0x20}, // A..Z -> a..z
+    {0x00C0, 0x00D6, 0x20}, // À..Ö -> à..ö
+    {0x00D8, 0x00DE, 0x20}, // Ø..Þ -> ø..þ
+    {0x0400, 0x040F, 0x50}, // Ѐ..Џ (Ё included) -> ѐ..џ
+    {0x0410, 0x042F, 0x20}, // А..Я -> а..я
+};
+
+constexpr char16_t foldCase(char16_t ch) noexcept
+{
+    if (ch < kFoldRanges[0].first || ch > kFoldRanges[std::size(kFoldRanges) - 1].last)
+        return ch;
+
+    for (auto const& range: kFoldRanges)
+        if (ch >= range.first && ch <= range.last)
+            return static_cast<char16_t>(ch + range.delta);
+
+    return ch;
+}
+
+// Compares an already folded key with a name in arbitrary case.
+constexpr bool equalsFolded(std::u16string_view foldedKey, std::u16string_view name) noexcept
+{
+    if (foldedKey.size() != name.size())
+        return false;
+
+    for (std::size_t i = 0; i < name.size(); ++i)
+        if (foldedKey[i] != foldCase(name[i]))
+            return false;
+
+    return true;
+}
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_CASEFOLDING_H
@@ -6,12 +6,17 @@
 #include <c12cxx/details/api/IMemoryManager.h>
 #include <c12cxx/details/api/types.h>
 
+#include <c12cxx/details/MemberTable.h>
 #include <c12cxx/details/Method.h>
 #include <c12cxx/details/Property.h>
+#include <c12cxx/details/StaticMembers.h>
 #include <c12cxx/details/ValueAccessor.h>
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace c12cxx {
@@ -67,30 +72,44 @@ public:
                               const long lSizeArray) final;
 
 public:
-    Property& addProperty(std::u16string const& name, std::u16string const& alt)
+    // Registers a member of this instance only; members common to a component type belong to its MemberTable.
+    Property& addProperty(std::u16string_view name, std::u16string_view alt)
     {
-        properties_.emplace_back(name, alt);
-        return properties_.back();
+        return ownMembers_.addProperty(name, alt);
     }
 
-    Method& addMethod(std::u16string const& name, std::u16string const& alt)
-    {
-        methods_.emplace_back(name, alt);
-        return methods_.back();
-    }
+    Method& addMethod(std::u16string_view name, std::u16string_view alt) { return ownMembers_.addMethod(name, alt); }
+
+    // String (VTYPE_PSTR) arguments and property values are checked to be valid UTF-8 before they reach a handler,
+    // and the call fails otherwise. A component trusting its caller may turn the check off.
+    void setUtf8Validation(bool enabled) noexcept { validateUtf8_ = enabled; }
+
+    // Encoding of the strings handlers take and return (see StringPolicy); AsIs by default.
+    void setStringPolicy(StringPolicy policy) noexcept { stringPolicy_ = policy; }
 
     bool hasError() const noexcept { return !errorMessage_.empty(); }
 
     std::u16string errorMessage() const { return errorMessage_; }
 
-    const std::vector<Property>& properties() const noexcept { return properties_; }
+    MemberList<Property> properties() const noexcept
+    {
+        return {typeMembers_->properties(), ownMembers_.properties()};
+    }
 
-    const std::vector<Method>& methods() const noexcept { return methods_; }
+    MemberList<Method> methods() const noexcept { return {typeMembers_->methods(), ownMembers_.methods()}; }
+
+    // Members every component has: HasError, ErrorMessage, ClearError and CallBatch.
+    static MemberTable const& baseMembers();
 
 protected:
+    explicit Component(MemberTable const& typeMembers);
+
     void setError(std::u16string const& msg) { errorMessage_ = msg; }
     void clearError() { errorMessage_.clear(); }
 
+    // Memory manager of the host, e.g. for building results with HostStringWriter/HostBlobWriter.
+    IMemoryManager* memoryManager() const noexcept { return memoryManager_; }
+
 public:
     virtual std::u16string componentName() = 0;
 
@@ -106,8 +125,56 @@ private:
     IAddInDefBase* connection_{};
     IMemoryManager* memoryManager_{};
 
-    std::vector<Property> properties_;
-    std::vector<Method> methods_;
+    MemberTable const* typeMembers_;
+    MemberTable ownMembers_;
+
+    bool validateUtf8_{true};
+    StringPolicy stringPolicy_{StringPolicy::AsIs};
+
+    void checkUtf8(tVariant* vars, std::size_t count) const;
+
+    Property const* property(long lPropNum) const noexcept;
+    Method const* method(long lMethodNum) const noexcept;
+
+    // Copies a member name into memory allocated from the host; null if that fails.
+    WCHAR_T* copyName(std::u16string_view name) const noexcept;
+
+    // CallBatch: runs the calls encoded in the batch (see Batch.h) and returns their encoded results.
+    std::vector<char> callBatch(std::pair<const char*, const char*> batch);
+};
+
+// Base for components whose members are described once per type. T declares its members at compile time with
+//
+//     static constexpr auto members() { return c12cxx::members(c12cxx::method<&T::ping>(u"Ping", u"Пинг")); }
+//
+// (see StaticMembers.h) and/or registers them at run time with
+//
+//     static void describe(c12cxx::MemberTable& members);
+//
+// using member function pointers as handlers, e.g.
+//
+//     members.addMethod(u"Ping", u"Пинг").withHandler(&T::ping);
+//
+// The table is built on first construction and then shared by all instances of T. Members declared by members()
+// come first and are called through a dispatcher generated for T.
+template<typename T>
+class TypedComponent: public Component {
+public:
+    static MemberTable const& typeMembers()
+    {
+        static const MemberTable members = [] {
+            MemberTable ret = Component::baseMembers();
+            if constexpr (has_static_members_v<T>)
+                StaticDispatch<T, decltype(T::members())>::registerMembers(ret, T::members());
+            if constexpr (has_describe_v<T>)
+                T::describe(ret);
+            return ret;
+        }();
+        return members;
+    }
+
+protected:
+    TypedComponent(): Component(typeMembers()) { }
 };
 
 } // namespace c12cxx
@@ -0,0 +1,80 @@
+#ifndef C12CXX_DETAILS_ENCODEDVALUE_H
+#define C12CXX_DETAILS_ENCODEDVALUE_H
+
+#include <c12cxx/details/ValueAccessor.h>
+#include <c12cxx/details/api/types.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace c12cxx {
+
+// Value encoded once into the form passed to the host, e.g. a default parameter value. Writing it out is a copy of
+// the variant, plus a single copy of the buffer for a string or blob; a string is transcoded instead if the target's
+// StringPolicy asks for the other string type.
+class EncodedValue {
+public:
+    explicit EncodedValue(Variant const& value)
+    {
+        tVarInit(&value_);
+        std::visit([this](auto const& alternative) { encode(alternative); }, value);
+    }
+
+    void writeTo(ValueAccessor target) const
+    {
+        switch (TV_VT(&value_)) {
+        case VTYPE_PWSTR:
+            target.setValue(std::u16string_view(reinterpret_cast<char16_t const*>(buffer_.data()), value_.wstrLen));
+            break;
+        case VTYPE_PSTR: target.setValue(std::string_view(buffer_.data(), value_.strLen)); break;
+        default: target.setEncoded(value_, std::string_view(buffer_.data(), buffer_.size())); break;
+        }
+    }
+
+private:
+    tVariant value_;
+    // String contents including the terminator, or blob contents.
+    std::vector<char> buffer_;
+
+    template<typename T>
+    void encode(T const& value)
+    {
+        ValueAccessor(&value_).setValue(value);
+    }
+
+    void encode(std::u16string const& value)
+    {
+        setBuffer(value.data(), value.size() * sizeof(char16_t), sizeof(char16_t));
+        TV_VT(&value_) = VTYPE_PWSTR;
+        value_.wstrLen = value.size();
+    }
+
+    void encode(std::string const& value)
+    {
+        setBuffer(value.data(), value.size(), sizeof(char));
+        TV_VT(&value_) = VTYPE_PSTR;
+        value_.strLen = value.size();
+    }
+
+    void encode(std::vector<unsigned char> const& value)
+    {
+        setBuffer(value.data(), value.size(), 0);
+        TV_VT(&value_) = VTYPE_BLOB;
+        value_.strLen = value.size();
+    }
+
+    void setBuffer(void const* data, std::size_t size, std::size_t terminator)
+    {
+        buffer_.assign(size + terminator, 0);
+        if (size != 0)
+            std::memcpy(buffer_.data(), data, size);
+    }
+};
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_ENCODEDVALUE_H
@@ -0,0 +1,140 @@
+#ifndef C12CXX_DETAILS_HOSTWRITER_H
+#define C12CXX_DETAILS_HOSTWRITER_H
+
+#include <c12cxx/details/api/IMemoryManager.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace c12cxx {
+
+// Builds a string or blob result directly in memory allocated with the host's memory manager. Returned from a
+// handler, the buffer is handed over to the host as is, so a large result is not copied once more from a
+// std::u16string or std::vector. The buffer grows geometrically and is handed over as is: the host goes by the length
+// stored in the variant, not by the size of the allocation.
+template<typename Char, bool NulTerminated>
+class BasicHostWriter {
+public:
+    explicit BasicHostWriter(IMemoryManager* memoryManager) noexcept: memoryManager_(memoryManager) { }
+
+    BasicHostWriter(BasicHostWriter const&) = delete;
+    BasicHostWriter& operator=(BasicHostWriter const&) = delete;
+
+    BasicHostWriter(BasicHostWriter&& other) noexcept:
+        memoryManager_(other.memoryManager_),
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0))
+    { }
+
+    BasicHostWriter& operator=(BasicHostWriter&& other) noexcept
+    {
+        if (this != &other) {
+            freeBuffer();
+            memoryManager_ = other.memoryManager_;
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~BasicHostWriter() { freeBuffer(); }
+
+    std::size_t size() const noexcept { return size_; }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    Char* data() noexcept { return data_; }
+
+    Char const* data() const noexcept { return data_; }
+
+    void reserve(std::size_t capacity)
+    {
+        if (capacity > capacity_)
+            reallocate(capacity);
+    }
+
+    void append(Char const* data, std::size_t size)
+    {
+        if (size == 0)
+            return;
+
+        if (size_ + size > capacity_)
+            reallocate(std::max(size_ + size, capacity_ + capacity_ / 2 + kMinCapacity));
+
+        std::memcpy(data_ + size_, data, size * sizeof(Char));
+        size_ += size;
+    }
+
+    void append(std::basic_string_view<Char> str) { append(str.data(), str.size()); }
+
+    void push_back(Char ch) { append(&ch, 1); }
+
+    // Hands the buffer over; the writer is left empty. The buffer is shrunk only if most of it is unused, e.g. after
+    // a too generous reserve, since shrinking means one more allocation and a copy.
+    std::pair<Char*, std::size_t> release()
+    {
+        if (size_ == 0 && !NulTerminated) {
+            freeBuffer();
+            return {nullptr, 0};
+        }
+
+        if (data_ == nullptr || size_ < capacity_ / 2)
+            reallocate(size_);
+        if constexpr (NulTerminated)
+            data_[size_] = Char{};
+
+        capacity_ = 0;
+        return {std::exchange(data_, nullptr), std::exchange(size_, 0)};
+    }
+
+private:
+    static constexpr std::size_t kMinCapacity = 64;
+
+    IMemoryManager* memoryManager_{};
+    Char* data_{};
+    std::size_t size_{};
+    std::size_t capacity_{};
+
+    // Room for the terminator is allocated beyond the capacity.
+    void reallocate(std::size_t capacity)
+    {
+        const std::size_t bytes = (capacity + (NulTerminated ? 1 : 0)) * sizeof(Char);
+
+        Char* data = nullptr;
+        if (!memoryManager_ || !memoryManager_->AllocMemory(reinterpret_cast<void**>(&data), bytes) || data == nullptr)
+            throw std::bad_alloc();
+
+        if (data_) {
+            std::memcpy(data, data_, size_ * sizeof(Char));
+            memoryManager_->FreeMemory(reinterpret_cast<void**>(&data_));
+        }
+
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void freeBuffer() noexcept
+    {
+        if (data_ && memoryManager_)
+            memoryManager_->FreeMemory(reinterpret_cast<void**>(&data_));
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+};
+
+// Result of VTYPE_PWSTR type.
+using HostStringWriter = BasicHostWriter<char16_t, true>;
+
+// Result of VTYPE_BLOB type.
+using HostBlobWriter = BasicHostWriter<char, false>;
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_HOSTWRITER_H
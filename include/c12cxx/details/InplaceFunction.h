@@ -0,0 +1,128 @@
+#ifndef C12CXX_DETAILS_INPLACEFUNCTION_H
+#define C12CXX_DETAILS_INPLACEFUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace c12cxx {
+
+inline constexpr std::size_t kInplaceFunctionCapacity = 64;
+
+template<typename Signature, std::size_t Capacity = kInplaceFunctionCapacity>
+class InplaceFunction;
+
+// Copyable type-erased callable stored in a fixed buffer. Unlike std::function it never allocates: a callable that
+// does not fit is rejected at compile time. A call is a single indirect call through the stored invoker.
+template<typename Ret, typename... Args, std::size_t Capacity>
+class InplaceFunction<Ret(Args...), Capacity> {
+public:
+    InplaceFunction() noexcept = default;
+
+    InplaceFunction(std::nullptr_t) noexcept { } // NOLINT(google-explicit-constructor)
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+    InplaceFunction(F&& fn) // NOLINT(google-explicit-constructor, bugprone-forwarding-reference-overload)
+    {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity,
+                      "Callable is too large for InplaceFunction: capture less (e.g. by reference) or raise Capacity.");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callable is over-aligned for InplaceFunction.");
+        static_assert(std::is_copy_constructible_v<Fn>, "InplaceFunction requires a copyable callable.");
+        static_assert(std::is_invocable_r_v<Ret, Fn&, Args...>, "Callable does not match the signature.");
+
+        ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(fn));
+        invoke_ = &invokeImpl<Fn>;
+        manage_ = &manageImpl<Fn>;
+    }
+
+    InplaceFunction(InplaceFunction const& other): invoke_(other.invoke_), manage_(other.manage_)
+    {
+        if (manage_)
+            manage_(Operation::Copy, storage_, other.storage_);
+    }
+
+    // The moved-from function is left empty.
+    InplaceFunction(InplaceFunction&& other) noexcept: invoke_(other.invoke_), manage_(other.manage_)
+    {
+        if (manage_)
+            manage_(Operation::Move, storage_, other.storage_);
+        other.invoke_ = nullptr;
+        other.manage_ = nullptr;
+    }
+
+    InplaceFunction& operator=(InplaceFunction const& other)
+    {
+        if (this != &other) {
+            InplaceFunction tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+            if (manage_)
+                manage_(Operation::Move, storage_, other.storage_);
+            other.invoke_ = nullptr;
+            other.manage_ = nullptr;
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~InplaceFunction() { reset(); }
+
+    explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+    Ret operator()(Args... args) const { return invoke_(storage_, std::forward<Args>(args)...); }
+
+private:
+    // Move destroys the source after moving from it.
+    enum class Operation { Copy, Move, Destroy };
+
+    alignas(std::max_align_t) mutable unsigned char storage_[Capacity]{};
+    Ret (*invoke_)(void* storage, Args&&... args){};
+    void (*manage_)(Operation operation, void* dst, void* src){};
+
+    void reset() noexcept
+    {
+        if (manage_)
+            manage_(Operation::Destroy, storage_, nullptr);
+        invoke_ = nullptr;
+        manage_ = nullptr;
+    }
+
+    template<typename Fn>
+    static Ret invokeImpl(void* storage, Args&&... args)
+    {
+        return (*static_cast<Fn*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template<typename Fn>
+    static void manageImpl(Operation operation, void* dst, void* src)
+    {
+        switch (operation) {
+        case Operation::Copy: ::new (dst) Fn(*static_cast<Fn const*>(src)); break;
+        case Operation::Move:
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+            break;
+        case Operation::Destroy: static_cast<Fn*>(dst)->~Fn(); break;
+        }
+    }
+};
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_INPLACEFUNCTION_H
@@ -0,0 +1,88 @@
+#ifndef C12CXX_DETAILS_MEMBERTABLE_H
+#define C12CXX_DETAILS_MEMBERTABLE_H
+
+#include <c12cxx/details/Method.h>
+#include <c12cxx/details/NameIndex.h>
+#include <c12cxx/details/NamePool.h>
+#include <c12cxx/details/Property.h>
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace c12cxx {
+
+// Properties and methods of a component together with the pool of their names and the name indexes.
+// A component type keeps one immutable table shared by all of its instances (see TypedComponent); every instance
+// additionally owns a table for the members registered at run time.
+class MemberTable {
+public:
+    Property& addProperty(std::u16string_view name, std::u16string_view alt)
+    {
+        properties_.emplace_back(names_, name, alt);
+        propertyIndex_.insert(names_, properties_, properties_.size() - 1);
+        return properties_.back();
+    }
+
+    Method& addMethod(std::u16string_view name, std::u16string_view alt)
+    {
+        methods_.emplace_back(names_, name, alt);
+        methodIndex_.insert(names_, methods_, methods_.size() - 1);
+        return methods_.back();
+    }
+
+    long findProperty(const char16_t* name) const noexcept { return propertyIndex_.find(name, names_, properties_); }
+
+    long findMethod(const char16_t* name) const noexcept { return methodIndex_.find(name, names_, methods_); }
+
+    // NUL-terminated name or alias of a member.
+    std::u16string_view propertyName(std::size_t index, bool alias) const noexcept
+    {
+        return nameOf(properties_[index], alias);
+    }
+
+    std::u16string_view methodName(std::size_t index, bool alias) const noexcept { return nameOf(methods_[index], alias); }
+
+    NamePool const& names() const noexcept { return names_; }
+
+    const std::vector<Property>& properties() const noexcept { return properties_; }
+
+    const std::vector<Method>& methods() const noexcept { return methods_; }
+
+private:
+    NamePool names_;
+    std::vector<Property> properties_;
+    std::vector<Method> methods_;
+
+    NameIndex propertyIndex_;
+    NameIndex methodIndex_;
+
+    std::u16string_view nameOf(Metadata const& member, bool alias) const noexcept
+    {
+        return names_.view(alias ? member.getAlt() : member.getName());
+    }
+};
+
+// Read-only view over the members of a component: the ones shared by its type followed by its own.
+template<typename T>
+class MemberList {
+public:
+    MemberList(std::vector<T> const& shared, std::vector<T> const& own) noexcept: shared_(shared), own_(own) { }
+
+    size_t size() const noexcept { return shared_.size() + own_.size(); }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    T const& operator[](size_t pos) const noexcept
+    {
+        return pos < shared_.size() ? shared_[pos] : own_[pos - shared_.size()];
+    }
+
+private:
+    std::vector<T> const& shared_;
+    std::vector<T> const& own_;
+};
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_MEMBERTABLE_H
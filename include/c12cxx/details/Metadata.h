@@ -1,25 +1,37 @@
 #ifndef C12CXX_DETAILS_METADATA_H
 #define C12CXX_DETAILS_METADATA_H
 
-#include <string>
+#include <c12cxx/details/NamePool.h>
+
+#include <string_view>
 
 namespace c12cxx {
 
+// Names of a member, stored in the pool of the MemberTable it belongs to together with their case folded keys.
 class Metadata {
 public:
     Metadata() = delete;
 
-    Metadata(std::u16string const& aName, std::u16string const& aAlt): name_(aName), alt_(aAlt) { }
+    Metadata(NamePool& names, std::u16string_view aName, std::u16string_view aAlt):
+        name_(names.add(aName)),
+        alt_(names.add(aAlt)),
+        nameKey_(names.addFolded(aName)),
+        altKey_(names.addFolded(aAlt))
+    { }
+
+    NamePool::Name getName() const noexcept { return name_; }
 
-    bool nameIs(std::u16string const& test) const noexcept { return (name_ == test || alt_ == test); }
+    NamePool::Name getAlt() const noexcept { return alt_; }
 
-    const std::u16string& getName() const noexcept { return name_; }
+    NamePool::Name getNameKey() const noexcept { return nameKey_; }
 
-    const std::u16string& getAlt() const noexcept { return alt_; }
+    NamePool::Name getAltKey() const noexcept { return altKey_; }
 
 private:
-    std::u16string name_;
-    std::u16string alt_;
+    NamePool::Name name_;
+    NamePool::Name alt_;
+    NamePool::Name nameKey_;
+    NamePool::Name altKey_;
 };
 
 } // namespace c12cxx
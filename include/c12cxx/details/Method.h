@@ -1,32 +1,139 @@
 #ifndef C12CXX_DETAILS_METHOD_H
 #define C12CXX_DETAILS_METHOD_H
 
+#include <c12cxx/details/EncodedValue.h>
+#include <c12cxx/details/InplaceFunction.h>
 #include <c12cxx/details/Metadata.h>
 #include <c12cxx/details/MethodWrapper.h>
+#include <c12cxx/details/ParamSpan.h>
 #include <c12cxx/details/ValueAccessor.h>
 #include <c12cxx/details/api/types.h>
+#include <c12cxx/details/function_traits.h>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
-#include <functional>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
-#include <variant>
+#include <vector>
 
 namespace c12cxx {
 
+class Component;
+
 class Method: public Metadata {
 public:
+    // Calls the method with the given index of a component type; generated for compile-time member declarations.
+    using Dispatcher = bool (*)(Component& component,
+                                std::size_t index,
+                                ValueAccessor varRetValue,
+                                ParamSpan const& params);
+
     Method() = delete;
 
-    Method(std::u16string const& aName, std::u16string const& aAlt): Metadata(aName, aAlt) { }
+    Method(NamePool& names, std::u16string_view aName, std::u16string_view aAlt): Metadata(names, aName, aAlt) { }
 
+    // Accepts a callable or a member function pointer. A member function is called on the component the method
+    // is invoked for, so such methods can be described once per component type (see TypedComponent).
     template<typename Handler>
     Method& withHandler(Handler handler)
     {
         MethodWrapper wrapper(handler);
         isFunction_ = wrapper.isFunction();
         numberOfParams_ = wrapper.numberOfParams();
-        handler_ = std::move(wrapper);
+        isVariadic_ = false;
+        setOptionalParams(wrapper.paramTypes());
+        handler_ = makeHandler(wrapper);
+        dispatcher_ = nullptr;
+        overloads_.clear();
+        dispatchTables_ = {};
+
+        return *this;
+    }
+
+    // Adds one more handler under the method name. The call is routed by the types of the passed arguments, which
+    // should tell the overloads apart: parameters an overload does not take count as Undefined (VTYPE_EMPTY), and
+    // overloads accepting the same argument types are rejected here rather than on call. A string the component's
+    // StringPolicy transcodes is routed to an overload taking it as is if there is one, and to the first one added
+    // that accepts it transcoded otherwise. A method given a single handler (withHandler, withVariadicHandler) has no
+    // overloads to add to and is rejected, rather than losing that handler.
+    template<typename Handler>
+    Method& withOverload(Handler handler)
+    {
+        MethodWrapper wrapper(handler);
+
+        if (overloads_.empty() && (handler_ || dispatcher_))
+            throw std::logic_error("Method already has a single handler; describe every variant with withOverload.");
+        if (overloads_.size() == kMaxOverloads)
+            throw std::logic_error("Too many method overloads.");
+        if (!overloads_.empty() && isFunction_ != wrapper.isFunction())
+            throw std::logic_error("Method overloads should be either all functions or all procedures.");
+
+        Overload overload{makeHandler(wrapper), {}};
+        for (std::size_t policy = 0; policy < kStringPolicyCount; ++policy) {
+            auto const types = wrapper.paramTypes(static_cast<StringPolicy>(policy));
+            overload.paramTypes[policy].assign(types.begin(), types.end());
+        }
+        for (auto const& other: overloads_) {
+            if (isAmbiguous(overload, other))
+                throw std::logic_error("Method overloads accept the same argument types.");
+        }
+
+        isFunction_ = wrapper.isFunction();
+        numberOfParams_ = std::max(overloads_.empty() ? 0 : numberOfParams_, overload.arity());
+        isVariadic_ = false;
+        handler_ = nullptr;
+        dispatcher_ = nullptr;
+        overloads_.push_back(std::move(overload));
+        buildDispatchTable();
+
+        return *this;
+    }
+
+    // Accepts a handler taking all the arguments at once, as a ParamSpan or a std::vector<Variant>, for methods
+    // called with any number of arguments up to maxParams. The host always passes maxParams arguments, the omitted
+    // ones as Undefined, so trailing Undefined arguments of such a call are not passed to the handler: an Undefined
+    // passed explicitly last cannot be told from an omitted one. A caller passing fewer arguments passes exactly the
+    // ones it means, and all of them reach the handler.
+    template<typename Handler>
+    Method& withVariadicHandler(Handler handler, std::size_t maxParams)
+    {
+        using traits = function_traits<Handler>;
+        static_assert(traits::arity == 1, "Variadic handler should take a single parameter.");
+        using Arg = std::remove_cv_t<std::remove_reference_t<typename traits::template arg_type<0>>>;
+        static_assert(std::is_same_v<Arg, ParamSpan> || std::is_same_v<Arg, std::vector<Variant>>,
+                      "Variadic handler should take ParamSpan or std::vector<Variant>.");
+
+        isFunction_ = !std::is_void_v<typename traits::return_type>;
+        numberOfParams_ = maxParams;
+        isVariadic_ = true;
+        optionalParams_ = 0;
+        handler_ = [handler, maxParams](Component& component, ValueAccessor varRetValue, ParamSpan const& params)
+            mutable -> bool { return callVariadic<Arg>(handler, component, varRetValue, params, maxParams); };
+        dispatcher_ = nullptr;
+        overloads_.clear();
+        dispatchTables_ = {};
+
+        return *this;
+    }
+
+    template<typename Wrapper>
+    Method& withDispatcher(Dispatcher dispatcher, std::size_t index, Wrapper wrapper)
+    {
+        isFunction_ = wrapper.isFunction();
+        numberOfParams_ = wrapper.numberOfParams();
+        isVariadic_ = false;
+        setOptionalParams(wrapper.paramTypes());
+        handler_ = nullptr;
+        dispatcher_ = dispatcher;
+        dispatchIndex_ = index;
+        overloads_.clear();
+        dispatchTables_ = {};
 
         return *this;
     }
@@ -37,40 +144,245 @@ public:
         return withHandler([&obj, method](Args... args) -> Ret { return (obj.*method)(std::forward<Args>(args)...); });
     }
 
+    // Values are encoded here once, so that passing a default to the host is a plain copy.
     Method& withDefaults(std::unordered_map<long, Variant> const& values)
     {
-        defaultValues_ = values;
+        std::vector<std::optional<EncodedValue>> defaultValues;
+        for (auto const& [paramNum, value]: values) {
+            if (paramNum < 0)
+                throw std::invalid_argument("Invalid default parameter number.");
+            if (static_cast<std::size_t>(paramNum) >= defaultValues.size())
+                defaultValues.resize(paramNum + 1);
+            defaultValues[paramNum].emplace(value);
+        }
+
+        defaultValues_ = std::move(defaultValues);
         return *this;
     }
 
+    // Parameters accepting Undefined, e.g. std::optional ones, default to it unless given another default value.
     bool getParamDefValue(long lParamNum, ValueAccessor valueAccessor) const
     {
-        auto it = defaultValues_.find(lParamNum);
-        if (it == defaultValues_.end())
-            return false;
+        if (lParamNum >= 0 && static_cast<std::size_t>(lParamNum) < defaultValues_.size() &&
+            defaultValues_[lParamNum]) {
+            defaultValues_[lParamNum]->writeTo(valueAccessor);
+            return true;
+        }
 
-        std::visit([&valueAccessor](auto const& value) { valueAccessor.setValue(value); }, it->second);
+        if (lParamNum >= 0 && isOptionalParam(static_cast<std::size_t>(lParamNum))) {
+            valueAccessor.setValue(std::monostate{});
+            return true;
+        }
 
-        return true;
+        return false;
     }
 
     size_t numberOfParams() const noexcept { return numberOfParams_; }
 
     bool isFunction() const noexcept { return isFunction_; }
 
-    bool doCall(ValueAccessor varRetValue, std::vector<ValueAccessor>& params) const
+    bool doCall(Component& component, ValueAccessor varRetValue, ParamSpan const& params) const
     {
+        if (dispatcher_)
+            return dispatcher_(component, dispatchIndex_, varRetValue, params);
+
         if (handler_)
-            return handler_(varRetValue, params);
+            return handler_(component, varRetValue, params);
+
+        if (!overloads_.empty()) {
+            auto const& overload = selectOverload(params);
+            return overload.handler(component, varRetValue, params.first(overload.arity()));
+        }
 
         return false;
     }
 
 private:
+    using Handler = InplaceFunction<bool(Component& component, ValueAccessor varRetValue, ParamSpan const& params)>;
+
+    struct Overload {
+        Handler handler;
+        // Variant types accepted by each parameter under each StringPolicy.
+        std::array<std::vector<std::uint32_t>, kStringPolicyCount> paramTypes;
+
+        std::size_t arity() const noexcept { return paramTypes[0].size(); }
+    };
+
+    // Bit set of the overloads accepting each variant type at a parameter position.
+    using DispatchRow = std::array<std::uint32_t, kScalarTypeCount>;
+
+    static constexpr std::size_t kMaxOverloads = 32;
+
+    // Only the leading parameters are tracked as optional, which covers any practical method.
+    static constexpr std::size_t kMaxOptionalParams = 64;
+
     size_t numberOfParams_{};
     bool isFunction_{};
-    std::function<bool(ValueAccessor varRetValue, std::vector<ValueAccessor> const& params)> handler_;
-    std::unordered_map<long, Variant> defaultValues_;
+    bool isVariadic_{};
+    Handler handler_;
+    Dispatcher dispatcher_{};
+    std::size_t dispatchIndex_{};
+    std::vector<Overload> overloads_;
+    std::array<std::vector<DispatchRow>, kStringPolicyCount> dispatchTables_;
+    std::vector<std::optional<EncodedValue>> defaultValues_;
+    std::uint64_t optionalParams_{};
+
+    template<typename Fn>
+    static Handler makeHandler(MethodWrapper<Fn> wrapper)
+    {
+        if constexpr (std::is_member_function_pointer_v<Fn>) {
+            return [wrapper](Component& component, ValueAccessor varRetValue, ParamSpan const& params) mutable
+                   -> bool { return wrapper(static_cast<member_class_t<Fn>&>(component), varRetValue, params); };
+        } else {
+            return [wrapper](Component&, ValueAccessor varRetValue, ParamSpan const& params) mutable -> bool {
+                return wrapper(varRetValue, params);
+            };
+        }
+    }
+
+    template<typename Arg, typename Fn>
+    static bool callVariadic(Fn& handler,
+                             Component& component,
+                             ValueAccessor varRetValue,
+                             ParamSpan const& params,
+                             std::size_t maxParams)
+    {
+        if (params.size() > maxParams)
+            throw std::invalid_argument("Invalid number of params.");
+
+        auto size = params.size();
+        if (size == maxParams) {
+            while (size > 0 && params[size - 1].type() == VTYPE_EMPTY)
+                --size;
+        }
+
+        Arg args{};
+        if constexpr (std::is_same_v<Arg, ParamSpan>) {
+            args = params.first(size);
+        } else {
+            args.resize(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                if (!params[i].tryGetValue(args[i]))
+                    throw std::runtime_error("Type conversion error: parameter " + std::to_string(i + 1) + ".");
+            }
+        }
+
+        auto invoke = [&handler, &component, &args]() -> decltype(auto) {
+            if constexpr (std::is_member_function_pointer_v<Fn>)
+                return (static_cast<member_class_t<Fn>&>(component).*handler)(args);
+            else
+                return handler(args);
+        };
+
+        if constexpr (std::is_void_v<typename function_traits<Fn>::return_type>)
+            invoke();
+        else
+            varRetValue.setValue(invoke());
+
+        return true;
+    }
+
+    bool isOptionalParam(std::size_t paramNum) const noexcept
+    {
+        if (isVariadic_)
+            return paramNum < numberOfParams_;
+
+        return paramNum < kMaxOptionalParams && ((optionalParams_ >> paramNum) & 1) != 0;
+    }
+
+    template<typename ParamTypes>
+    void setOptionalParams(ParamTypes const& types)
+    {
+        optionalParams_ = 0;
+        for (std::size_t i = 0; i < types.size() && i < kMaxOptionalParams; ++i) {
+            if (types[i] & typeBit(VTYPE_EMPTY))
+                optionalParams_ |= std::uint64_t{1} << i;
+        }
+    }
+
+    static std::uint32_t paramTypesAt(Overload const& overload,
+                                      std::size_t position,
+                                      StringPolicy stringPolicy = StringPolicy::AsIs) noexcept
+    {
+        auto const& types = overload.paramTypes[static_cast<std::size_t>(stringPolicy)];
+        return position < types.size() ? types[position] : typeBit(VTYPE_EMPTY);
+    }
+
+    static bool isAmbiguous(Overload const& lhs, Overload const& rhs) noexcept
+    {
+        auto const arity = std::max(lhs.arity(), rhs.arity());
+        for (std::size_t i = 0; i < arity; ++i) {
+            if ((paramTypesAt(lhs, i) & paramTypesAt(rhs, i)) == 0)
+                return false;
+        }
+        return true;
+    }
+
+    void buildDispatchTable()
+    {
+        std::size_t minArity = numberOfParams_;
+        for (auto const& overload: overloads_)
+            minArity = std::min(minArity, overload.arity());
+
+        for (std::size_t policy = 0; policy < kStringPolicyCount; ++policy) {
+            auto& table = dispatchTables_[policy];
+            table.assign(numberOfParams_, DispatchRow{});
+            for (std::size_t i = 0; i < numberOfParams_; ++i) {
+                for (std::size_t no = 0; no < overloads_.size(); ++no) {
+                    auto const types = paramTypesAt(overloads_[no], i, static_cast<StringPolicy>(policy));
+                    for (std::size_t vt = 0; vt < kScalarTypeCount; ++vt) {
+                        if (types & typeBit(static_cast<TYPEVAR>(vt)))
+                            table[i][vt] |= std::uint32_t{1} << no;
+                    }
+                }
+            }
+        }
+
+        auto const& table = dispatchTables_[static_cast<std::size_t>(StringPolicy::AsIs)];
+        optionalParams_ = 0;
+        for (std::size_t i = 0; i < numberOfParams_; ++i) {
+            // Optional past the shortest overload, so that it can be called with fewer arguments, or if every
+            // overload accepts Undefined there.
+            if (i < kMaxOptionalParams && (i >= minArity || table[i][VTYPE_EMPTY] == allOverloads()))
+                optionalParams_ |= std::uint64_t{1} << i;
+        }
+    }
+
+    std::uint32_t allOverloads() const noexcept
+    {
+        return overloads_.size() == kMaxOverloads ? ~std::uint32_t{0} : (std::uint32_t{1} << overloads_.size()) - 1;
+    }
+
+    std::uint32_t candidatesFor(ParamSpan const& params, StringPolicy stringPolicy) const noexcept
+    {
+        auto const& table = dispatchTables_[static_cast<std::size_t>(stringPolicy)];
+        auto candidates = allOverloads();
+        for (std::size_t i = 0; i < params.size() && candidates != 0; ++i) {
+            auto const vt = params[i].type();
+            candidates &= vt < kScalarTypeCount ? table[i][vt] : 0;
+        }
+        return candidates;
+    }
+
+    Overload const& selectOverload(ParamSpan const& params) const
+    {
+        if (params.size() != numberOfParams_)
+            throw std::invalid_argument("Invalid number of params.");
+
+        // Overloads are unambiguous for arguments taken as is, so at most one candidate is left; with strings
+        // transcoded there may be more, the first one added being called.
+        auto candidates = candidatesFor(params, StringPolicy::AsIs);
+        if (candidates == 0 && params.stringPolicy() != StringPolicy::AsIs)
+            candidates = candidatesFor(params, params.stringPolicy());
+        if (candidates == 0)
+            throw std::runtime_error("No method overload accepts the given argument types.");
+
+        std::size_t no = 0;
+        while ((candidates & (std::uint32_t{1} << no)) == 0)
+            ++no;
+
+        return overloads_[no];
+    }
 };
 
 } // namespace c12cxx
@@ -3,7 +3,11 @@
 
 #include <c12cxx/details/ValueAccessor.h>
 #include <c12cxx/details/function_traits.h>
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -35,16 +39,66 @@ private:
     template<typename Tuple>
     using remove_cvrefptr_tuple_t = typename remove_cvrefptr_tuple<Tuple>::type;
 
+    // Non-const lvalue reference parameters are written back to the host after the call.
+    template<typename Arg>
+    static constexpr bool is_output_v =
+        std::is_lvalue_reference_v<Arg> && !std::is_const_v<std::remove_reference_t<Arg>>;
+
+    template<std::size_t... Is>
+    static constexpr bool hasBorrowedOutput(std::index_sequence<Is...>)
+    {
+        using traits = function_traits<Handler>;
+        return ((is_output_v<typename traits::template arg_type<Is>> &&
+                 is_borrowed_v<remove_cvrefptr_t<typename traits::template arg_type<Is>>>) ||
+                ...);
+    }
+
 public:
     MethodWrapper() = default;
 
-    MethodWrapper(Handler handler): handler_(handler) { }
+    MethodWrapper(Handler handler): handler_(handler)
+    {
+        static_assert(!hasBorrowedOutput(std::make_index_sequence<function_traits<Handler>::arity>{}),
+                      "String views and byte ranges borrow the host buffer and cannot be output parameters; "
+                      "take them by value or const reference.");
+    }
 
     bool isFunction() { return !std::is_void_v<typename function_traits<Handler>::return_type>; }
 
     size_t numberOfParams() { return function_traits<Handler>::arity; }
 
-    bool operator()(ValueAccessor varRetValue, std::vector<ValueAccessor> const& params)
+    // Variant types (see ValueAccessor::acceptedTypes) accepted by each parameter of the handler.
+    static auto paramTypes(StringPolicy stringPolicy = StringPolicy::AsIs)
+    {
+        return paramTypesImpl(stringPolicy, std::make_index_sequence<function_traits<Handler>::arity>{});
+    }
+
+    // Params is any indexable sequence of ValueAccessor: a ParamSpan over the host array or a std::vector.
+    template<typename Params>
+    bool operator()(ValueAccessor varRetValue, Params const& params)
+    {
+        return call(varRetValue, params, [this](auto&... args) { return handler_(args...); });
+    }
+
+    // Calls a member function handler on the given object.
+    template<typename Object, typename Params>
+    bool operator()(Object& object, ValueAccessor varRetValue, Params const& params)
+    {
+        static_assert(std::is_member_function_pointer_v<Handler>, "Handler is not a member function pointer.");
+        return call(varRetValue, params, [this, &object](auto&... args) { return (object.*handler_)(args...); });
+    }
+
+private:
+    template<std::size_t... Is>
+    static std::array<std::uint32_t, sizeof...(Is)> paramTypesImpl([[maybe_unused]] StringPolicy stringPolicy,
+                                                                   std::index_sequence<Is...>)
+    {
+        return {ValueAccessor::acceptedTypes<
+            remove_cvrefptr_t<typename function_traits<Handler>::template arg_type<Is>>>(stringPolicy)...};
+    }
+
+    template<typename Params, typename Invoker>
+    bool call(ValueAccessor varRetValue, Params const& params, Invoker invoker)
     {
         if (params.size() != numberOfParams())
             throw std::invalid_argument("Invalid number of params.");
@@ -52,18 +106,18 @@ public:
         auto args = paramsToArgs(params);
 
         if constexpr (std::is_void_v<typename function_traits<Handler>::return_type>) {
-            std::apply(handler_, args);
+            std::apply(invoker, args);
         } else {
-            auto ret = std::apply(handler_, args);
-            varRetValue.setValue(ret);
+            auto ret = std::apply(invoker, args);
+            varRetValue.setValue(std::move(ret));
         }
 
         updateOutputParams(params, args);
         return true;
     }
 
-private:
-    auto paramsToArgs(std::vector<ValueAccessor> const& params)
+    template<typename Params>
+    auto paramsToArgs(Params const& params)
     {
         using src_args_types = typename function_traits<Handler>::args_tuple;
         using dst_args_types = remove_cvrefptr_tuple_t<src_args_types>;
@@ -71,8 +125,8 @@ private:
         return fillTupleFromParams<dst_args_types>(params);
     }
 
-    template<typename Tuple>
-    Tuple fillTupleFromParams(std::vector<ValueAccessor> const& params)
+    template<typename Tuple, typename Params>
+    Tuple fillTupleFromParams(Params const& params)
     {
         constexpr std::size_t N = std::tuple_size_v<Tuple>;
 
@@ -83,34 +137,38 @@ private:
         return fillTupleFromParamsImpl<Tuple>(params, std::make_index_sequence<N>{});
     }
 
-    template<typename Tuple, std::size_t... Is>
-    Tuple fillTupleFromParamsImpl(std::vector<ValueAccessor> const& params, std::index_sequence<Is...>)
+    template<typename Tuple, typename Params, std::size_t... Is>
+    Tuple fillTupleFromParamsImpl(Params const& params, std::index_sequence<Is...>)
     {
-        return Tuple{params[Is].getValue<std::tuple_element_t<Is, Tuple>>()...};
+        // Conversions report failures by status, so a mismatch costs a single throw for the whole call.
+        Tuple args{};
+        std::size_t failed = sizeof...(Is);
+        (void)((params[Is].tryGetValue(std::get<Is>(args)) || ((failed = Is), false)) && ...);
+
+        if (failed != sizeof...(Is))
+            throw std::runtime_error("Type conversion error: parameter " + std::to_string(failed + 1) + ".");
+
+        return args;
     }
 
-    template<typename T>
-    void updateOutputParam(ValueAccessor param, T const& value, bool isOutput)
+    template<bool IsOutput, typename T>
+    void updateOutputParam(ValueAccessor param, T const& value)
     {
-        if (isOutput) {
-            param.setValue(value);
+        if constexpr (IsOutput) {
+            param.updateValue(value);
         }
     }
 
-    template<typename Tuple, std::size_t... Is>
-    void updateOutputParamsImpl(std::vector<ValueAccessor> const& params,
-                                Tuple const& tuple,
-                                std::index_sequence<Is...>)
+    template<typename Params, typename Tuple, std::size_t... Is>
+    void updateOutputParamsImpl(Params const& params, Tuple const& tuple, std::index_sequence<Is...>)
     {
-        (updateOutputParam(params[Is],
-                           std::get<Is>(tuple),
-                           (std::is_reference_v<typename function_traits<Handler>::template arg_type<Is>> &&
-                            !std::is_const_v<typename function_traits<Handler>::template arg_type<Is>>)),
+        (updateOutputParam<is_output_v<typename function_traits<Handler>::template arg_type<Is>>>(
+             params[Is], std::get<Is>(tuple)),
          ...);
     }
 
-    template<typename Tuple, std::size_t TupSize = std::tuple_size<std::decay_t<Tuple>>::value>
-    void updateOutputParams(std::vector<ValueAccessor> const& params, Tuple const& tuple)
+    template<typename Params, typename Tuple, std::size_t TupSize = std::tuple_size<std::decay_t<Tuple>>::value>
+    void updateOutputParams(Params const& params, Tuple const& tuple)
     {
         if (params.size() < TupSize)
             throw std::invalid_argument("params list too small");
@@ -0,0 +1,173 @@
+#ifndef C12CXX_DETAILS_NAMEINDEX_H
+#define C12CXX_DETAILS_NAMEINDEX_H
+
+#include <c12cxx/details/CaseFolding.h>
+#include <c12cxx/details/NamePool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace c12cxx {
+
+// Open-addressing hash table over both names (name and alt) of every member of a Metadata list.
+// Keys are the case folded names Metadata keeps in the NamePool, so only the name being looked up is folded, once,
+// into a buffer on the stack and compared to the keys as is.
+// Slots keep the full hash of the key, so a lookup performs a single string compare in the usual case.
+// The table is filled incrementally while members are registered and never changes during a lookup, so lookups
+// neither allocate nor copy the name they are given.
+class NameIndex {
+public:
+    static std::uint32_t hash(std::u16string_view name) noexcept
+    {
+        std::uint32_t h = kOffsetBasis;
+        for (char16_t ch: name) {
+            h ^= foldCase(ch);
+            h *= kPrime;
+        }
+        return h ^ (h >> 16);
+    }
+
+    template<typename Items>
+    void insert(NamePool const& names, Items const& items, std::size_t member)
+    {
+        insertKey(names, items, member, false);
+        insertKey(names, items, member, true);
+    }
+
+    template<typename Items>
+    long find(std::u16string_view name, NamePool const& names, Items const& items) const noexcept
+    {
+        char16_t folded[kMaxFoldedSize];
+        std::uint32_t h = kOffsetBasis;
+        for (std::size_t i = 0; i < name.size(); ++i) {
+            const char16_t ch = foldCase(name[i]);
+            if (i < kMaxFoldedSize)
+                folded[i] = ch;
+            h ^= ch;
+            h *= kPrime;
+        }
+
+        return find(name, folded, h ^ (h >> 16), names, items);
+    }
+
+    // Looks up a NUL-terminated name straight from a host buffer, measuring, folding and hashing it in one pass.
+    template<typename Items>
+    long find(const char16_t* name, NamePool const& names, Items const& items) const noexcept
+    {
+        if (name == nullptr)
+            return -1;
+
+        char16_t folded[kMaxFoldedSize];
+        std::uint32_t h = kOffsetBasis;
+        const char16_t* end = name;
+        for (; *end != 0; ++end) {
+            const char16_t ch = foldCase(*end);
+            if (static_cast<std::size_t>(end - name) < kMaxFoldedSize)
+                folded[end - name] = ch;
+            h ^= ch;
+            h *= kPrime;
+        }
+
+        return find(std::u16string_view(name, static_cast<std::size_t>(end - name)), folded, h ^ (h >> 16), names,
+                    items);
+    }
+
+    void clear() noexcept
+    {
+        slots_.clear();
+        size_ = 0;
+    }
+
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    static constexpr std::uint32_t kOffsetBasis = 2166136261U;
+    static constexpr std::uint32_t kPrime = 16777619U;
+    static constexpr std::size_t kMinCapacity = 16;
+    // Longer names are folded again for every key compared, which no practical identifier needs.
+    static constexpr std::size_t kMaxFoldedSize = 64;
+
+    struct Slot {
+        std::uint32_t hash{};
+        std::int32_t key{-1}; // (member << 1) | isAlt, negative for an empty slot
+    };
+
+    std::vector<Slot> slots_;
+    std::size_t size_{};
+
+    std::size_t mask() const noexcept { return slots_.size() - 1; }
+
+    template<typename Items>
+    static std::u16string_view keyOf(NamePool const& names, Items const& items, std::int32_t key) noexcept
+    {
+        auto const& item = items[static_cast<std::size_t>(key >> 1)];
+        return names.view((key & 1) != 0 ? item.getAltKey() : item.getNameKey());
+    }
+
+    // folded holds the name folded if it fits into kMaxFoldedSize.
+    template<typename Items>
+    long find(std::u16string_view name,
+              char16_t const* folded,
+              std::uint32_t h,
+              NamePool const& names,
+              Items const& items) const noexcept
+    {
+        if (slots_.empty())
+            return -1;
+
+        const bool isFolded = name.size() <= kMaxFoldedSize;
+        for (std::size_t pos = h & mask();; pos = (pos + 1) & mask()) {
+            Slot const& slot = slots_[pos];
+            if (slot.key < 0)
+                return -1;
+            if (slot.hash != h)
+                continue;
+
+            auto const key = keyOf(names, items, slot.key);
+            if (isFolded ? key == std::u16string_view(folded, name.size()) : equalsFolded(key, name))
+                return slot.key >> 1;
+        }
+    }
+
+    template<typename Items>
+    void insertKey(NamePool const& names, Items const& items, std::size_t member, bool isAlt)
+    {
+        if ((size_ + 1) * 2 > slots_.size())
+            rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+
+        const auto key = static_cast<std::int32_t>((member << 1) | (isAlt ? 1 : 0));
+        const std::u16string_view name = keyOf(names, items, key);
+        const std::uint32_t h = hash(name);
+
+        std::size_t pos = h & mask();
+        for (; slots_[pos].key >= 0; pos = (pos + 1) & mask()) {
+            // The first registered member wins, the same way a linear scan would resolve duplicates.
+            if (slots_[pos].hash == h && keyOf(names, items, slots_[pos].key) == name)
+                return;
+        }
+
+        slots_[pos] = Slot{h, key};
+        ++size_;
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        std::vector<Slot> old(capacity);
+        old.swap(slots_);
+
+        for (Slot const& slot: old) {
+            if (slot.key < 0)
+                continue;
+            std::size_t pos = slot.hash & mask();
+            while (slots_[pos].key >= 0)
+                pos = (pos + 1) & mask();
+            slots_[pos] = slot;
+        }
+    }
+};
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_NAMEINDEX_H
@@ -0,0 +1,59 @@
+#ifndef C12CXX_DETAILS_NAMEPOOL_H
+#define C12CXX_DETAILS_NAMEPOOL_H
+
+#include <c12cxx/details/CaseFolding.h>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace c12cxx {
+
+// Member names of a MemberTable kept one after another in a single buffer, each followed by a NUL, so that lookups
+// compare names lying next to each other and a name can be handed to the host with a single copy. Members refer to
+// their names by position rather than by pointer, so a table is copied together with its pool as is.
+class NamePool {
+public:
+    struct Name {
+        std::uint32_t offset{};
+        std::uint32_t size{};
+    };
+
+    Name add(std::u16string_view name)
+    {
+        const Name ret = nextName(name.size());
+        data_.insert(data_.end(), name.begin(), name.end());
+        data_.push_back(u'\0');
+        return ret;
+    }
+
+    // Stores the name case folded (see foldCase), as a lookup key.
+    Name addFolded(std::u16string_view name)
+    {
+        const Name ret = nextName(name.size());
+        for (char16_t ch: name)
+            data_.push_back(foldCase(ch));
+        data_.push_back(u'\0');
+        return ret;
+    }
+
+    std::u16string_view view(Name name) const noexcept { return {data_.data() + name.offset, name.size}; }
+
+    // The name is NUL-terminated.
+    char16_t const* data(Name name) const noexcept { return data_.data() + name.offset; }
+
+    std::size_t size() const noexcept { return data_.size(); }
+
+private:
+    std::vector<char16_t> data_;
+
+    // The vector grows geometrically on its own; reserving for each name would reallocate every time.
+    Name nextName(std::size_t size) const noexcept
+    {
+        return Name{static_cast<std::uint32_t>(data_.size()), static_cast<std::uint32_t>(size)};
+    }
+};
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_NAMEPOOL_H
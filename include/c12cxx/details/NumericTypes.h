@@ -0,0 +1,131 @@
+#ifndef C12CXX_DETAILS_NUMERICTYPES_H
+#define C12CXX_DETAILS_NUMERICTYPES_H
+
+#include <c12cxx/details/api/types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace c12cxx {
+
+// Numbers exchanged in binary form (packed numeric blobs, batches) are little-endian whatever the CPU.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr bool kLittleEndian = false;
+#else
+inline constexpr bool kLittleEndian = true;
+#endif
+
+// Reverses the bytes of every element of a packed array, converting it between native and little-endian order on a
+// big-endian CPU.
+inline void swapElementBytes(void* data, std::size_t size, std::size_t elementSize) noexcept
+{
+    auto* bytes = static_cast<unsigned char*>(data);
+    for (std::size_t i = 0; i + elementSize <= size; i += elementSize)
+        std::reverse(bytes + i, bytes + i + elementSize);
+}
+
+// Numeric variant types: the C++ type of each one and the tVariant member holding it.
+template<TYPEVAR VT>
+struct numeric_vtype;
+
+#define C12CXX_NUMERIC_VTYPE(VT, TYPE, MEMBER)                        \
+    template<>                                                        \
+    struct numeric_vtype<VT> {                                        \
+        using type = TYPE;                                            \
+                                                                      \
+        template<typename Var>                                        \
+        static constexpr auto& of(Var& var) noexcept                  \
+        {                                                             \
+            return var.MEMBER;                                        \
+        }                                                             \
+    }
+
+C12CXX_NUMERIC_VTYPE(VTYPE_I1, std::int8_t, i8Val);
+C12CXX_NUMERIC_VTYPE(VTYPE_I2, std::int16_t, shortVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_I4, std::int32_t, lVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_I8, std::int64_t, llVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_UI1, std::uint8_t, ui8Val);
+C12CXX_NUMERIC_VTYPE(VTYPE_UI2, std::uint16_t, ushortVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_UI4, std::uint32_t, ulVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_UI8, std::uint64_t, ullVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_INT, int, intVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_UINT, unsigned int, uintVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_ERROR, std::int32_t, errCode);
+C12CXX_NUMERIC_VTYPE(VTYPE_R4, float, fltVal);
+C12CXX_NUMERIC_VTYPE(VTYPE_R8, double, dblVal);
+
+#undef C12CXX_NUMERIC_VTYPE
+
+using numeric_vtypes = std::integer_sequence<TYPEVAR,
+                                             VTYPE_I1,
+                                             VTYPE_I2,
+                                             VTYPE_I4,
+                                             VTYPE_I8,
+                                             VTYPE_UI1,
+                                             VTYPE_UI2,
+                                             VTYPE_UI4,
+                                             VTYPE_UI8,
+                                             VTYPE_INT,
+                                             VTYPE_UINT,
+                                             VTYPE_ERROR,
+                                             VTYPE_R4,
+                                             VTYPE_R8>;
+
+// Variant type an arithmetic value is written as: the one of the same kind and size.
+template<typename T>
+constexpr TYPEVAR numericTypeOf() noexcept
+{
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Arithmetic type expected.");
+
+    if constexpr (std::is_floating_point_v<T>) {
+        return sizeof(T) <= sizeof(float) ? VTYPE_R4 : VTYPE_R8;
+    } else if constexpr (std::is_signed_v<T>) {
+        return sizeof(T) == 1 ? VTYPE_I1 : sizeof(T) == 2 ? VTYPE_I2 : sizeof(T) == 4 ? VTYPE_I4 : VTYPE_I8;
+    } else {
+        return sizeof(T) == 1 ? VTYPE_UI1 : sizeof(T) == 2 ? VTYPE_UI2 : sizeof(T) == 4 ? VTYPE_UI4 : VTYPE_UI8;
+    }
+}
+
+// Converts between arithmetic types, failing instead of losing the value: integers should be in range and
+// floating-point values converted to integers should be whole. Converting to floating point only fails if the value
+// is out of range.
+template<typename To, typename From>
+bool convertNumber(From from, To& to) noexcept
+{
+    if constexpr (std::is_floating_point_v<To>) {
+        if constexpr (std::is_floating_point_v<From> && (sizeof(From) > sizeof(To))) {
+            const bool inRange = from >= std::numeric_limits<To>::lowest() && from <= std::numeric_limits<To>::max();
+            if (std::isfinite(from) && !inRange)
+                return false;
+        }
+    } else if constexpr (std::is_floating_point_v<From>) {
+        // The bounds are powers of two and thus exact; NaN fails the comparisons.
+        const From lower = std::is_signed_v<To> ? -std::ldexp(From{1}, std::numeric_limits<To>::digits) : From{0};
+        const From upper = std::ldexp(From{1}, std::numeric_limits<To>::digits);
+        if (!(from >= lower && from < upper) || std::trunc(from) != from)
+            return false;
+    } else if constexpr (std::is_signed_v<From>) {
+        if (from < 0) {
+            if constexpr (!std::is_signed_v<To>)
+                return false;
+            else if (static_cast<std::intmax_t>(from) < static_cast<std::intmax_t>(std::numeric_limits<To>::min()))
+                return false;
+        } else if (static_cast<std::uintmax_t>(from) > static_cast<std::uintmax_t>(std::numeric_limits<To>::max())) {
+            return false;
+        }
+    } else if (static_cast<std::uintmax_t>(from) > static_cast<std::uintmax_t>(std::numeric_limits<To>::max())) {
+        return false;
+    }
+
+    to = static_cast<To>(from);
+    return true;
+}
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_NUMERICTYPES_H
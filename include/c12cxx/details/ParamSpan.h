@@ -0,0 +1,54 @@
+#ifndef C12CXX_DETAILS_PARAMSPAN_H
+#define C12CXX_DETAILS_PARAMSPAN_H
+
+#include <c12cxx/details/ValueAccessor.h>
+#include <c12cxx/details/api/IMemoryManager.h>
+#include <c12cxx/details/api/types.h>
+
+#include <cstddef>
+
+namespace c12cxx {
+
+// Non-owning view over the parameter array passed by the host to CallAsProc/CallAsFunc. Accessors are created on
+// demand, so passing parameters to a method needs neither a copy of the array nor a heap allocation.
+class ParamSpan {
+public:
+    ParamSpan() noexcept = default;
+
+    ParamSpan(tVariant* params,
+              std::size_t size,
+              IMemoryManager* memoryManager = nullptr,
+              StringPolicy stringPolicy = StringPolicy::AsIs) noexcept:
+        params_(params),
+        size_(params ? size : 0),
+        memoryManager_(memoryManager),
+        stringPolicy_(stringPolicy)
+    { }
+
+    std::size_t size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    StringPolicy stringPolicy() const noexcept { return stringPolicy_; }
+
+    // Leading parameters only, e.g. the ones taken by a particular overload.
+    ParamSpan first(std::size_t count) const noexcept
+    {
+        return ParamSpan(params_, count < size_ ? count : size_, memoryManager_, stringPolicy_);
+    }
+
+    ValueAccessor operator[](std::size_t index) const noexcept
+    {
+        return ValueAccessor(&params_[index], memoryManager_, stringPolicy_);
+    }
+
+private:
+    tVariant* params_{};
+    std::size_t size_{};
+    IMemoryManager* memoryManager_{};
+    StringPolicy stringPolicy_{StringPolicy::AsIs};
+};
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_PARAMSPAN_H
@@ -1,11 +1,12 @@
 #ifndef C12CXX_DETAILS_PROPERTY_H
 #define C12CXX_DETAILS_PROPERTY_H
 
+#include <c12cxx/details/InplaceFunction.h>
 #include <c12cxx/details/Metadata.h>
 #include <c12cxx/details/ValueAccessor.h>
 
 #include <c12cxx/details/function_traits.h>
-#include <functional>
+#include <string_view>
 #include <type_traits>
 
 namespace c12cxx {
@@ -48,21 +49,39 @@ public:
 };
 */
 
+class Component;
+
 class Property: public Metadata {
 public:
+    // Reads or writes the property with the given index of a component type; generated for compile-time member
+    // declarations.
+    using Dispatcher = bool (*)(Component& component, std::size_t index, ValueAccessor varValue);
+
     Property() = delete;
 
-    Property(std::u16string const& aName, std::u16string const& aAlt): Metadata(aName, aAlt) { }
+    Property(NamePool& names, std::u16string_view aName, std::u16string_view aAlt): Metadata(names, aName, aAlt)
+    { }
 
+    // Accepts a callable or a member function pointer. A member function is called on the component the property
+    // is accessed for, so such properties can be described once per component type (see TypedComponent).
     template<typename Getter>
     Property& withGetter(Getter getter)
     {
         if constexpr (std::is_same_v<std::nullptr_t, Getter>) {
             getter_ = nullptr;
             isReadable_ = false;
+        } else if constexpr (std::is_member_function_pointer_v<Getter>) {
+            using class_type = member_class_t<Getter>;
+            static_assert(!std::is_void_v<std::invoke_result_t<Getter, class_type&>>,
+                          "Invalid getter signature, should be T().");
+            getter_ = [getter](Component& component, ValueAccessor varValue) -> bool {
+                varValue.setValue((static_cast<class_type&>(component).*getter)());
+                return true;
+            };
+            isReadable_ = true;
         } else {
             static_assert(!std::is_void_v<std::invoke_result_t<Getter>>, "Invalid getter signature, should be T().");
-            getter_ = [getter](ValueAccessor varValue) -> bool {
+            getter_ = [getter](Component&, ValueAccessor varValue) -> bool {
                 varValue.setValue(getter());
                 return true;
             };
@@ -89,12 +108,20 @@ public:
                               (function_traits<Setter>::arity == 1) &&
                               !std::is_void_v<typename function_traits<Setter>::template arg_type<0>>,
                           "Invalid Setter signature, should be void(T).");
-            setter_ = [setter](ValueAccessor varValue) -> bool {
-                using arg_type = std::remove_const_t<std::remove_reference_t<
-                    std::remove_pointer_t<typename function_traits<Setter>::template arg_type<0>>>>;
-                setter(varValue.getValue<arg_type>());
-                return true;
-            };
+            using arg_type = std::remove_const_t<
+                std::remove_reference_t<std::remove_pointer_t<typename function_traits<Setter>::template arg_type<0>>>>;
+
+            if constexpr (std::is_member_function_pointer_v<Setter>) {
+                setter_ = [setter](Component& component, ValueAccessor varValue) -> bool {
+                    (static_cast<member_class_t<Setter>&>(component).*setter)(varValue.getValue<arg_type>());
+                    return true;
+                };
+            } else {
+                setter_ = [setter](Component&, ValueAccessor varValue) -> bool {
+                    setter(varValue.getValue<arg_type>());
+                    return true;
+                };
+            }
             isWritable_ = true;
         }
 
@@ -108,22 +135,41 @@ public:
         return withSetter([&obj, method](Arg arg) { (obj.*method)(arg); });
     }
 
+    Property& withDispatchers(Dispatcher getter, Dispatcher setter, std::size_t index)
+    {
+        getter_ = nullptr;
+        setter_ = nullptr;
+        getDispatcher_ = getter;
+        setDispatcher_ = setter;
+        dispatchIndex_ = index;
+        isReadable_ = getter != nullptr;
+        isWritable_ = setter != nullptr;
+
+        return *this;
+    }
+
     bool isReadable() const noexcept { return isReadable_; }
 
     bool isWritable() const noexcept { return isWritable_; }
 
-    bool callGetter(ValueAccessor valueAccessor)
+    bool callGetter(Component& component, ValueAccessor valueAccessor) const
     {
+        if (getDispatcher_)
+            return getDispatcher_(component, dispatchIndex_, valueAccessor);
+
         if (getter_)
-            return getter_(valueAccessor);
+            return getter_(component, valueAccessor);
 
         return false;
     }
 
-    bool callSetter(ValueAccessor valueAccessor)
+    bool callSetter(Component& component, ValueAccessor valueAccessor) const
     {
+        if (setDispatcher_)
+            return setDispatcher_(component, dispatchIndex_, valueAccessor);
+
         if (setter_)
-            return setter_(valueAccessor);
+            return setter_(component, valueAccessor);
 
         return false;
     }
@@ -131,8 +177,11 @@ public:
 private:
     bool isReadable_{};
     bool isWritable_{};
-    std::function<bool(ValueAccessor)> getter_{nullptr};
-    std::function<bool(ValueAccessor)> setter_{nullptr};
+    InplaceFunction<bool(Component&, ValueAccessor)> getter_{nullptr};
+    InplaceFunction<bool(Component&, ValueAccessor)> setter_{nullptr};
+    Dispatcher getDispatcher_{};
+    Dispatcher setDispatcher_{};
+    std::size_t dispatchIndex_{};
 };
 
 } // namespace c12cxx
@@ -0,0 +1,250 @@
+#ifndef C12CXX_DETAILS_STATICMEMBERS_H
+#define C12CXX_DETAILS_STATICMEMBERS_H
+
+#include <c12cxx/details/MemberTable.h>
+#include <c12cxx/details/MethodWrapper.h>
+#include <c12cxx/details/ParamSpan.h>
+#include <c12cxx/details/ValueAccessor.h>
+#include <c12cxx/details/function_traits.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace c12cxx {
+
+class Component;
+
+// Compile-time member declarations. A component type lists its members as
+//
+//     static constexpr auto members()
+//     {
+//         return c12cxx::members(c12cxx::method<&T::ping>(u"Ping", u"Пинг"),
+//                                c12cxx::property<&T::value, &T::setValue>(u"Value", u"Значение"));
+//     }
+//
+// and TypedComponent generates the dispatch for them: a single function per component type that selects the member
+// by its index and calls it directly, without std::function and with the handler known at compile time.
+
+template<auto Handler>
+struct MethodDef {
+    static_assert(std::is_member_function_pointer_v<decltype(Handler)>, "Method handler should be a member function.");
+
+    std::u16string_view name;
+    std::u16string_view alt;
+};
+
+template<auto Getter, auto Setter>
+struct PropertyDef {
+    static_assert(std::is_null_pointer_v<decltype(Getter)> || std::is_member_function_pointer_v<decltype(Getter)>,
+                  "Property getter should be a member function or nullptr.");
+    static_assert(std::is_null_pointer_v<decltype(Setter)> || std::is_member_function_pointer_v<decltype(Setter)>,
+                  "Property setter should be a member function or nullptr.");
+
+    std::u16string_view name;
+    std::u16string_view alt;
+};
+
+template<auto Handler>
+constexpr MethodDef<Handler> method(std::u16string_view name, std::u16string_view alt) noexcept
+{
+    return {name, alt};
+}
+
+template<auto Getter, auto Setter = nullptr>
+constexpr PropertyDef<Getter, Setter> property(std::u16string_view name, std::u16string_view alt) noexcept
+{
+    return {name, alt};
+}
+
+template<typename... Defs>
+constexpr std::tuple<Defs...> members(Defs... defs) noexcept
+{
+    return {defs...};
+}
+
+template<typename T, typename = void>
+struct has_static_members: std::false_type { };
+
+template<typename T>
+struct has_static_members<T, std::void_t<decltype(T::members())>>: std::true_type { };
+
+template<typename T>
+inline constexpr bool has_static_members_v = has_static_members<T>::value;
+
+template<typename T, typename = void>
+struct has_describe: std::false_type { };
+
+template<typename T>
+struct has_describe<T, std::void_t<decltype(T::describe(std::declval<MemberTable&>()))>>: std::true_type { };
+
+template<typename T>
+inline constexpr bool has_describe_v = has_describe<T>::value;
+
+template<typename T, typename Defs>
+class StaticDispatch {
+private:
+    template<typename Def>
+    struct traits {
+        static constexpr bool is_method = false;
+        static constexpr bool is_property = false;
+    };
+
+    template<auto Handler>
+    struct traits<MethodDef<Handler>> {
+        static constexpr bool is_method = true;
+        static constexpr bool is_property = false;
+    };
+
+    template<auto Getter, auto Setter>
+    struct traits<PropertyDef<Getter, Setter>> {
+        static constexpr bool is_method = false;
+        static constexpr bool is_property = true;
+        static constexpr bool is_readable = !std::is_null_pointer_v<decltype(Getter)>;
+        static constexpr bool is_writable = !std::is_null_pointer_v<decltype(Setter)>;
+    };
+
+    static constexpr std::size_t kSize = std::tuple_size_v<Defs>;
+
+    template<std::size_t I>
+    using def_t = std::tuple_element_t<I, Defs>;
+
+public:
+    static void registerMembers(MemberTable& table, Defs const& defs)
+    {
+        registerMembersImpl(table, defs, std::make_index_sequence<kSize>{});
+    }
+
+    static bool callMethod(Component& component,
+                           std::size_t index,
+                           ValueAccessor varRetValue,
+                           ParamSpan const& params)
+    {
+        return callMethodImpl(
+            static_cast<T&>(component), index, varRetValue, params, std::make_index_sequence<kSize>{});
+    }
+
+    static bool getProperty(Component& component, std::size_t index, ValueAccessor varValue)
+    {
+        return getPropertyImpl(static_cast<T&>(component), index, varValue, std::make_index_sequence<kSize>{});
+    }
+
+    static bool setProperty(Component& component, std::size_t index, ValueAccessor varValue)
+    {
+        return setPropertyImpl(static_cast<T&>(component), index, varValue, std::make_index_sequence<kSize>{});
+    }
+
+private:
+    template<std::size_t... Is>
+    static void registerMembersImpl(MemberTable& table, Defs const& defs, std::index_sequence<Is...>)
+    {
+        (registerMember<Is>(table, std::get<Is>(defs)), ...);
+    }
+
+    template<std::size_t I, typename Def>
+    static void registerMember(MemberTable& table, Def const& def)
+    {
+        if constexpr (traits<Def>::is_method) {
+            table.addMethod(def.name, def.alt)
+                .withDispatcher(&StaticDispatch::callMethod, I, wrapperOf(def));
+        } else if constexpr (traits<Def>::is_property) {
+            table.addProperty(def.name, def.alt)
+                .withDispatchers(traits<Def>::is_readable ? &StaticDispatch::getProperty : nullptr,
+                                 traits<Def>::is_writable ? &StaticDispatch::setProperty : nullptr,
+                                 I);
+        } else {
+            static_assert(traits<Def>::is_method, "Member declarations should be made with method() or property().");
+        }
+    }
+
+    template<auto Handler>
+    static auto wrapperOf(MethodDef<Handler> const&)
+    {
+        return MethodWrapper<decltype(Handler)>(Handler);
+    }
+
+    // The fold below is the generated switch: every case is a direct call of a compile-time known member function.
+    template<std::size_t... Is>
+    static bool callMethodImpl(T& obj,
+                               std::size_t index,
+                               ValueAccessor varRetValue,
+                               ParamSpan const& params,
+                               std::index_sequence<Is...>)
+    {
+        bool result = false;
+        (void)((index == Is && ((result = callMethodAt<Is>(obj, varRetValue, params)), true)) || ...);
+        return result;
+    }
+
+    template<std::size_t I>
+    static bool callMethodAt(T& obj, ValueAccessor varRetValue, ParamSpan const& params)
+    {
+        if constexpr (traits<def_t<I>>::is_method) {
+            return wrapperOf(def_t<I>{})(obj, varRetValue, params);
+        } else {
+            return false;
+        }
+    }
+
+    template<std::size_t... Is>
+    static bool getPropertyImpl(T& obj, std::size_t index, ValueAccessor varValue, std::index_sequence<Is...>)
+    {
+        bool result = false;
+        (void)((index == Is && ((result = getPropertyAt(obj, varValue, def_t<Is>{})), true)) || ...);
+        return result;
+    }
+
+    template<typename Def>
+    static bool getPropertyAt(T&, ValueAccessor, Def const&)
+    {
+        return false;
+    }
+
+    template<auto Getter, auto Setter>
+    static bool getPropertyAt(T& obj, ValueAccessor varValue, PropertyDef<Getter, Setter> const&)
+    {
+        if constexpr (std::is_null_pointer_v<decltype(Getter)>) {
+            return false;
+        } else {
+            varValue.setValue((obj.*Getter)());
+            return true;
+        }
+    }
+
+    template<std::size_t... Is>
+    static bool setPropertyImpl(T& obj, std::size_t index, ValueAccessor varValue, std::index_sequence<Is...>)
+    {
+        bool result = false;
+        (void)((index == Is && ((result = setPropertyAt(obj, varValue, def_t<Is>{})), true)) || ...);
+        return result;
+    }
+
+    template<typename Def>
+    static bool setPropertyAt(T&, ValueAccessor, Def const&)
+    {
+        return false;
+    }
+
+    template<auto Getter, auto Setter>
+    static bool setPropertyAt(T& obj, ValueAccessor varValue, PropertyDef<Getter, Setter> const&)
+    {
+        if constexpr (std::is_null_pointer_v<decltype(Setter)>) {
+            return false;
+        } else {
+            using setter_traits = function_traits<decltype(Setter)>;
+            static_assert(std::is_void_v<typename setter_traits::return_type> && (setter_traits::arity == 1),
+                          "Invalid setter signature, should be void(T).");
+            using arg_type = std::remove_const_t<
+                std::remove_reference_t<std::remove_pointer_t<typename setter_traits::template arg_type<0>>>>;
+            (obj.*Setter)(varValue.getValue<arg_type>());
+            return true;
+        }
+    }
+};
+
+} // namespace c12cxx
+
+#endif // C12CXX_DETAILS_STATICMEMBERS_H
@@ -1,15 +1,22 @@
 #ifndef C12CXX_DETAILS_VALUEACCESSOR_H
 #define C12CXX_DETAILS_VALUEACCESSOR_H
 
+#include <c12cxx/details/HostWriter.h>
+#include <c12cxx/details/NumericTypes.h>
 #include <c12cxx/details/api/IMemoryManager.h>
 #include <c12cxx/details/api/types.h>
 #include <c12cxx/details/isocalendar.h>
+#include <c12cxx/details/utfutils.h>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -17,8 +24,11 @@
 
 namespace c12cxx {
 
-using Variant = std::variant<bool,
+// Any value a handler can take or return; std::monostate stands for Undefined (VTYPE_EMPTY and VTYPE_NULL).
+using Variant = std::variant<std::monostate,
+                             bool,
                              int,
+                             std::int64_t,
                              double,
                              std::tm,
                              std::chrono::system_clock::time_point,
@@ -37,6 +47,47 @@ inline constexpr bool is_byte_pointer_pair_v<std::pair<First, Second>> =
      std::is_same_v<std::remove_cv_t<std::remove_pointer_t<First>>, signed char> ||
      std::is_same_v<std::remove_cv_t<std::remove_pointer_t<First>>, std::byte>);
 
+// Read-only view of binary data (VTYPE_BLOB). As a handler parameter or property setter argument it refers to the
+// host's buffer, so even a large blob is passed without a copy.
+class BlobView {
+public:
+    constexpr BlobView() noexcept = default;
+
+    constexpr BlobView(std::byte const* data, std::size_t size) noexcept: data_(data), size_(size) { }
+
+    BlobView(void const* data, std::size_t size) noexcept: data_(static_cast<std::byte const*>(data)), size_(size) { }
+
+    constexpr std::byte const* data() const noexcept { return data_; }
+
+    constexpr std::size_t size() const noexcept { return size_; }
+
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr std::byte const* begin() const noexcept { return data_; }
+
+    constexpr std::byte const* end() const noexcept { return data_ + size_; }
+
+    constexpr std::byte operator[](std::size_t index) const noexcept { return data_[index]; }
+
+private:
+    std::byte const* data_{};
+    std::size_t size_{};
+};
+
+// Parameter types referring to the host's buffer instead of a copy; valid only for the duration of the call.
+template<typename T>
+inline constexpr bool is_borrowed_v = std::is_same_v<T, std::u16string_view> || std::is_same_v<T, std::string_view> ||
+                                      std::is_same_v<T, BlobView> || is_byte_pointer_pair_v<T>;
+
+template<typename T>
+inline constexpr bool is_borrowed_v<std::optional<T>> = is_borrowed_v<T>;
+
+template<typename T>
+inline constexpr bool is_optional_v = false;
+
+template<typename T>
+inline constexpr bool is_optional_v<std::optional<T>> = true;
+
 template<typename T>
 struct is_vector: std::false_type { };
 
@@ -58,11 +109,44 @@ struct is_byte_vector<T,
 template<typename T>
 constexpr bool is_byte_vector_v = is_byte_vector<T>::value;
 
+// Vectors of wider numbers, e.g. std::vector<std::int32_t>, std::vector<std::int64_t> or std::vector<double>.
+template<typename T, typename = void>
+struct is_numeric_vector: std::false_type { };
+
+template<typename T>
+struct is_numeric_vector<T,
+                         std::enable_if_t<is_vector<T>::value && !is_byte_vector<T>::value &&
+                                          std::is_arithmetic_v<typename is_vector<T>::value_type> &&
+                                          !std::is_same_v<typename is_vector<T>::value_type, bool>>>
+    : std::true_type { };
+
+template<typename T>
+constexpr bool is_numeric_vector_v = is_numeric_vector<T>::value;
+
+// Scalar variant types, i.e. TYPEVAR values without the VTYPE_VECTOR/ARRAY/BYREF flags.
+inline constexpr std::size_t kScalarTypeCount = VTYPE_CLSID + 1;
+
+constexpr std::uint32_t typeBit(TYPEVAR vt) noexcept
+{
+    return vt < kScalarTypeCount ? std::uint32_t{1} << vt : 0;
+}
+
+// How a component exchanges strings with the host. With AsIs a string is passed in the type it has on either side:
+// std::string as VTYPE_PSTR and std::u16string as VTYPE_PWSTR. Utf8 and Utf16 name the type handlers work with:
+// strings are returned in that encoding, and std::string (Utf8) or std::u16string (Utf16) parameters accept the
+// other string type too, transcoded once on the way in. Borrowed views still need the matching host type.
+enum class StringPolicy { AsIs, Utf8, Utf16 };
+
+inline constexpr std::size_t kStringPolicyCount = 3;
+
 class ValueAccessor {
 public:
-    explicit ValueAccessor(tVariant* pVar = nullptr, IMemoryManager* memoryManager = nullptr):
+    explicit ValueAccessor(tVariant* pVar = nullptr,
+                           IMemoryManager* memoryManager = nullptr,
+                           StringPolicy stringPolicy = StringPolicy::AsIs):
         pVar_(pVar),
-        memoryManager_(memoryManager)
+        memoryManager_(memoryManager),
+        stringPolicy_(stringPolicy)
     { }
 
     void setValue(bool val)
@@ -75,35 +159,71 @@ public:
         pVar_->bVal = val;
     };
 
-    void setValue(int val)
+    // Any arithmetic type is written as the variant type of the same kind and size (see numericTypeOf).
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, void> setValue(T val)
     {
         if (pVar_ == nullptr)
             throw std::runtime_error("Unspecified variable access error.");
 
+        constexpr TYPEVAR vt = numericTypeOf<T>();
+        typename numeric_vtype<vt>::type stored{};
+        if (!convertNumber(val, stored))
+            throw std::range_error("Number is out of range.");
+
         tVarInit(pVar_);
-        TV_VT(pVar_) = VTYPE_I4;
-        pVar_->lVal = val;
-    };
+        TV_VT(pVar_) = vt;
+        numeric_vtype<vt>::of(*pVar_) = stored;
+    }
 
-    void setValue(long val)
+    void setValue(std::monostate)
     {
         if (pVar_ == nullptr)
             throw std::runtime_error("Unspecified variable access error.");
 
         tVarInit(pVar_);
-        TV_VT(pVar_) = VTYPE_I4;
-        pVar_->lVal = val;
-    };
+    }
+
+    // A template so that values convertible to Variant still pick their own overload.
+    template<typename V>
+    std::enable_if_t<std::is_same_v<V, Variant>, void> setValue(V const& val)
+    {
+        std::visit([this](auto const& value) { setValue(value); }, val);
+    }
 
-    void setValue(double val)
+    // Writes a value encoded in advance (see EncodedValue): the variant is copied as is, and for a string or blob the
+    // buffer, terminator included, is copied into memory allocated from the host.
+    void setEncoded(tVariant const& value, std::string_view buffer)
     {
         if (pVar_ == nullptr)
             throw std::runtime_error("Unspecified variable access error.");
 
+        const TYPEVAR vt = TV_VT(&value);
+        if (vt != VTYPE_PWSTR && vt != VTYPE_PSTR && vt != VTYPE_BLOB) {
+            *pVar_ = value;
+            return;
+        }
+
         tVarInit(pVar_);
-        TV_VT(pVar_) = VTYPE_R8;
-        pVar_->dblVal = val;
-    };
+        char* data = nullptr;
+        if (!memoryManager_ || !memoryManager_->AllocMemory(reinterpret_cast<void**>(&data), buffer.size()) ||
+            (data == nullptr))
+            throw std::bad_alloc();
+
+        memcpy(data, buffer.data(), buffer.size());
+        *pVar_ = value;
+        pVar_->pstrVal = data;
+    }
+
+    // An empty optional is written as Undefined.
+    template<typename Optional>
+    std::enable_if_t<is_optional_v<Optional>, void> setValue(Optional const& val)
+    {
+        if (val)
+            setValue(*val);
+        else
+            setValue(std::monostate{});
+    }
 
     void setValue(std::tm const& val)
     {
@@ -127,6 +247,11 @@ public:
         if (pVar_ == nullptr)
             throw std::runtime_error("Unspecified variable access error.");
 
+        if (stringPolicy_ == StringPolicy::Utf8) {
+            setValue(std::string_view{toUtf8(val)});
+            return;
+        }
+
         tVarInit(pVar_);
         TV_VT(pVar_) = VTYPE_EMPTY;
 
@@ -150,6 +275,11 @@ public:
         if (pVar_ == nullptr)
             throw std::runtime_error("Unspecified variable access error.");
 
+        if (stringPolicy_ == StringPolicy::Utf16) {
+            setUtf8AsWide(val);
+            return;
+        }
+
         tVarInit(pVar_);
         TV_VT(pVar_) = VTYPE_EMPTY;
 
@@ -168,6 +298,36 @@ public:
     //        setValue(std::string_view{val});
     //    }
 
+    // Writes UTF-8 text as VTYPE_PWSTR: the exact length is counted first and the text transcoded straight into
+    // memory allocated from the host, without an intermediate std::u16string.
+    void setUtf8AsWide(std::string_view val)
+    {
+        if (pVar_ == nullptr)
+            throw std::runtime_error("Unspecified variable access error.");
+
+        tVarInit(pVar_);
+        TV_VT(pVar_) = VTYPE_EMPTY;
+
+        const std::size_t length = utf16Length(val);
+        const size_t size = (length + 1) * sizeof(char16_t);
+        if (!memoryManager_ || !memoryManager_->AllocMemory(reinterpret_cast<void**>(&pVar_->pwstrVal), size) ||
+            (pVar_->pwstrVal == nullptr))
+            throw std::bad_alloc();
+
+        std::size_t written = 0;
+        try {
+            written = toUtf16(val, reinterpret_cast<char16_t*>(pVar_->pwstrVal), length);
+        } catch (...) {
+            memoryManager_->FreeMemory(reinterpret_cast<void**>(&pVar_->pwstrVal));
+            tVarInit(pVar_);
+            throw;
+        }
+
+        pVar_->pwstrVal[written] = 0;
+        TV_VT(pVar_) = VTYPE_PWSTR;
+        pVar_->wstrLen = written;
+    }
+
     template<typename ByteVector>
     std::enable_if_t<is_byte_vector_v<ByteVector>, void> setValue(ByteVector const& val)
     {
@@ -186,6 +346,30 @@ public:
         pVar_->strLen = val.size();
     }
 
+    // The host has no way to return a typed array, so numbers are packed into a blob: the elements one after another,
+    // little-endian (byte-swapped on a big-endian CPU). The same encoding is accepted on input.
+    template<typename NumericVector>
+    std::enable_if_t<is_numeric_vector_v<NumericVector>, void> setValue(NumericVector const& val)
+    {
+        if (pVar_ == nullptr)
+            throw std::runtime_error("Unspecified variable access error.");
+
+        const std::size_t size = val.size() * sizeof(typename NumericVector::value_type);
+
+        tVarInit(pVar_);
+        TV_VT(pVar_) = VTYPE_EMPTY;
+
+        if (!memoryManager_ || !memoryManager_->AllocMemory(reinterpret_cast<void**>(&pVar_->pstrVal), size) ||
+            (pVar_->pstrVal == nullptr))
+            throw std::bad_alloc();
+
+        memcpy(pVar_->pstrVal, val.data(), size);
+        if constexpr (!kLittleEndian)
+            swapElementBytes(pVar_->pstrVal, size, sizeof(typename NumericVector::value_type));
+        TV_VT(pVar_) = VTYPE_BLOB;
+        pVar_->strLen = size;
+    }
+
     template<typename BytePointerPair>
     std::enable_if_t<is_byte_pointer_pair_v<BytePointerPair>, void> setValue(BytePointerPair val)
     {
@@ -205,6 +389,109 @@ public:
         pVar_->strLen = val.second - val.first;
     }
 
+    void setValue(BlobView val)
+    {
+        if (pVar_ == nullptr)
+            throw std::runtime_error("Unspecified variable access error.");
+
+        tVarInit(pVar_);
+        TV_VT(pVar_) = VTYPE_EMPTY;
+
+        if (!memoryManager_ || !memoryManager_->AllocMemory(reinterpret_cast<void**>(&pVar_->pstrVal), val.size()) ||
+            (pVar_->pstrVal == nullptr))
+            throw std::bad_alloc();
+
+        memcpy(pVar_->pstrVal, val.data(), val.size());
+        TV_VT(pVar_) = VTYPE_BLOB;
+        pVar_->strLen = val.size();
+    }
+
+    // Hands the writer's buffer over to the variable without copying it.
+    void setValue(HostStringWriter&& val)
+    {
+        if (pVar_ == nullptr)
+            throw std::runtime_error("Unspecified variable access error.");
+
+        auto [data, size] = val.release();
+        tVarInit(pVar_);
+        TV_VT(pVar_) = VTYPE_PWSTR;
+        pVar_->pwstrVal = reinterpret_cast<WCHAR_T*>(data);
+        pVar_->wstrLen = size;
+    }
+
+    void setValue(HostBlobWriter&& val)
+    {
+        if (pVar_ == nullptr)
+            throw std::runtime_error("Unspecified variable access error.");
+
+        auto [data, size] = val.release();
+        tVarInit(pVar_);
+        TV_VT(pVar_) = VTYPE_BLOB;
+        pVar_->pstrVal = data;
+        pVar_->strLen = size;
+    }
+
+    // Writes an output parameter back to the variable it was read from, the referenced one for a VTYPE_VARIANT
+    // reference. Nothing is written if the value is unchanged; a string or blob buffer is reused if the new value fits
+    // into it and released otherwise. A string transcoded on the way in (see StringPolicy) is written back in the type
+    // the host passed.
+    template<typename T>
+    void updateValue(T const& val)
+    {
+        if (pVar_ == nullptr)
+            throw std::runtime_error("Unspecified variable access error.");
+
+        if (tVariant* var = referent(); var != pVar_) {
+            if (var == nullptr)
+                throw std::runtime_error("Unspecified variable access error.");
+            ValueAccessor(var, memoryManager_, stringPolicy_).updateValue(val);
+            return;
+        }
+
+        if constexpr (is_optional_v<T>) {
+            if (val) {
+                updateValue(*val);
+                return;
+            }
+        } else if constexpr (std::is_same_v<T, std::u16string>) {
+            if (reuseBuffer(VTYPE_PWSTR, val.data(), val.size(), sizeof(char16_t)))
+                return;
+            if (TV_VT(pVar_) == VTYPE_PSTR && stringPolicy_ == StringPolicy::Utf16) {
+                releaseBuffer();
+                ValueAccessor(pVar_, memoryManager_).setValue(std::string_view{toUtf8(val)});
+                return;
+            }
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            if (reuseBuffer(VTYPE_PSTR, val.data(), val.size(), sizeof(char)))
+                return;
+            if (TV_VT(pVar_) == VTYPE_PWSTR && stringPolicy_ == StringPolicy::Utf8) {
+                releaseBuffer();
+                setUtf8AsWide(val);
+                return;
+            }
+        } else if constexpr (is_byte_vector_v<T>) {
+            if (reuseBuffer(VTYPE_BLOB, val.data(), val.size(), 1))
+                return;
+        } else if constexpr (is_numeric_vector_v<T>) {
+            // Reused as is only where no byte swapping is needed.
+            if (kLittleEndian && reuseBuffer(VTYPE_BLOB, val.data(), val.size() * sizeof(typename T::value_type), 1))
+                return;
+        } else if constexpr (std::is_arithmetic_v<T> || std::is_same_v<T, std::chrono::system_clock::time_point>) {
+            T current{};
+            if (tryGetValue(current) && current == val)
+                return;
+
+            // A number keeps the variant type the host passed if it fits into it.
+            if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+                if (writeNumberInPlace(val, numeric_vtypes{}))
+                    return;
+            }
+        }
+
+        releaseBuffer();
+        setValue(val);
+    }
+
     template<typename T>
     T getValue() const
     {
@@ -213,54 +500,319 @@ public:
 
         static_assert(!std::is_reference_v<T>, "getValue<T> cannot return references — temporary would be destroyed");
 
-        if constexpr (std::is_same_v<T, bool>) {
-            if (TV_VT(pVar_) == VTYPE_BOOL)
-                return pVar_->bVal;
+        T value{};
+        if (!tryGetValue(value))
+            throw std::runtime_error("Type conversion error.");
 
-        } else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>) {
-            if (TV_VT(pVar_) == VTYPE_I2 || TV_VT(pVar_) == VTYPE_I4 || TV_VT(pVar_) == VTYPE_ERROR ||
-                TV_VT(pVar_) == VTYPE_UI1)
-                return pVar_->lVal;
-            if (TV_VT(pVar_) == VTYPE_R4 || TV_VT(pVar_) == VTYPE_R8)
-                return pVar_->dblVal;
+        return value;
+    }
 
+    // Non-throwing counterpart of getValue: stores the converted value and returns true, or returns false leaving
+    // the value untouched if the variable is not set or holds a type that cannot be converted to T.
+    template<typename T>
+    bool tryGetValue(T& value) const
+    {
+        if (pVar_ == nullptr)
+            return false;
+
+        if (tVariant* var = referent(); var != pVar_)
+            return var != nullptr && ValueAccessor(var, memoryManager_, stringPolicy_).tryGetValue(value);
+
+        if constexpr (std::is_same_v<T, Variant>) {
+            return readVariant(value);
+
+        } else if constexpr (is_optional_v<T>) {
+            if (TV_VT(pVar_) == VTYPE_EMPTY) {
+                value.reset();
+                return true;
+            }
+
+            typename T::value_type contained{};
+            if (!tryGetValue(contained))
+                return false;
+
+            value = std::move(contained);
+            return true;
+
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if (TV_VT(pVar_) == VTYPE_BOOL) {
+                value = pVar_->bVal;
+                return true;
+            }
+
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return readNumber(value, numeric_vtypes{});
         } else if constexpr (std::is_same_v<T, std::tm>) {
-            if (TV_VT(pVar_) == VTYPE_TM)
-                return pVar_->tmVal;
-            if (TV_VT(pVar_) == VTYPE_DATE)
-                return secondsToTm(pVar_->dblVal);
+            if (TV_VT(pVar_) == VTYPE_TM) {
+                value = pVar_->tmVal;
+                return true;
+            }
+            if (TV_VT(pVar_) == VTYPE_DATE) {
+                value = secondsToTm(pVar_->dblVal);
+                return true;
+            }
 
         } else if constexpr (std::is_same_v<T, std::chrono::system_clock::time_point>) {
-            if (TV_VT(pVar_) == VTYPE_TM)
-                return tmToTimePoint(pVar_->tmVal);
-            if (TV_VT(pVar_) == VTYPE_DATE)
-                return tmToTimePoint(secondsToTm(pVar_->dblVal));
+            if (TV_VT(pVar_) == VTYPE_TM) {
+                value = tmToTimePoint(pVar_->tmVal);
+                return true;
+            }
+            if (TV_VT(pVar_) == VTYPE_DATE) {
+                value = tmToTimePoint(secondsToTm(pVar_->dblVal));
+                return true;
+            }
 
         } else if constexpr (std::is_same_v<T, std::u16string> || std::is_same_v<T, std::u16string_view>) {
-            if (TV_VT(pVar_) == VTYPE_PWSTR)
-                return T(reinterpret_cast<const char16_t*>(pVar_->pwstrVal), pVar_->wstrLen);
+            if (TV_VT(pVar_) == VTYPE_PWSTR) {
+                value = T(reinterpret_cast<const char16_t*>(pVar_->pwstrVal), pVar_->wstrLen);
+                return true;
+            }
+            if constexpr (std::is_same_v<T, std::u16string>) {
+                if (TV_VT(pVar_) == VTYPE_PSTR && stringPolicy_ == StringPolicy::Utf16) {
+                    value = toUtf16(std::string_view(pVar_->pstrVal, pVar_->strLen));
+                    return true;
+                }
+            }
 
         } else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
-            if (TV_VT(pVar_) == VTYPE_PSTR)
-                return T(reinterpret_cast<const char*>(pVar_->pstrVal), pVar_->strLen);
+            if (TV_VT(pVar_) == VTYPE_PSTR) {
+                value = T(reinterpret_cast<const char*>(pVar_->pstrVal), pVar_->strLen);
+                return true;
+            }
+            if constexpr (std::is_same_v<T, std::string>) {
+                if (TV_VT(pVar_) == VTYPE_PWSTR && stringPolicy_ == StringPolicy::Utf8) {
+                    value = toUtf8(
+                        std::u16string_view(reinterpret_cast<const char16_t*>(pVar_->pwstrVal), pVar_->wstrLen));
+                    return true;
+                }
+            }
 
         } else if constexpr (is_byte_vector_v<T>) {
-            if (TV_VT(pVar_) == VTYPE_BLOB)
-                return T(reinterpret_cast<typename T::value_type*>(pVar_->pstrVal),
-                         reinterpret_cast<typename T::value_type*>(pVar_->pstrVal + pVar_->strLen));
+            if (TV_VT(pVar_) == VTYPE_BLOB) {
+                value = T(reinterpret_cast<typename T::value_type*>(pVar_->pstrVal),
+                          reinterpret_cast<typename T::value_type*>(pVar_->pstrVal + pVar_->strLen));
+                return true;
+            }
+
+        } else if constexpr (is_numeric_vector_v<T>) {
+            return readNumericVector(value);
+
+        } else if constexpr (std::is_same_v<T, BlobView>) {
+            if (TV_VT(pVar_) == VTYPE_BLOB) {
+                value = BlobView(pVar_->pstrVal, pVar_->strLen);
+                return true;
+            }
 
         } else if constexpr (is_byte_pointer_pair_v<T>) {
-            if (TV_VT(pVar_) == VTYPE_BLOB)
-                return std::make_pair(reinterpret_cast<typename T::first_type>(pVar_->pstrVal),
-                                      reinterpret_cast<typename T::first_type>(pVar_->pstrVal + pVar_->strLen));
+            if (TV_VT(pVar_) == VTYPE_BLOB) {
+                value = std::make_pair(reinterpret_cast<typename T::first_type>(pVar_->pstrVal),
+                                       reinterpret_cast<typename T::first_type>(pVar_->pstrVal + pVar_->strLen));
+                return true;
+            }
         }
 
-        throw std::runtime_error("Type conversion error.");
+        return false;
+    }
+
+    // Bit set (see typeBit) of the variant types tryGetValue<T> converts from under the given string policy; must be
+    // kept in sync with it.
+    template<typename T>
+    static constexpr std::uint32_t acceptedTypes(StringPolicy stringPolicy = StringPolicy::AsIs) noexcept
+    {
+        if constexpr (std::is_same_v<T, Variant>) {
+            return typeBit(VTYPE_EMPTY) | typeBit(VTYPE_NULL) | typeBit(VTYPE_BOOL) | numericTypeBits(numeric_vtypes{}) |
+                   typeBit(VTYPE_TM) | typeBit(VTYPE_DATE) | typeBit(VTYPE_PWSTR) | typeBit(VTYPE_PSTR) |
+                   typeBit(VTYPE_BLOB);
+        } else if constexpr (is_optional_v<T>) {
+            return typeBit(VTYPE_EMPTY) | acceptedTypes<typename T::value_type>(stringPolicy);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return typeBit(VTYPE_BOOL);
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return numericTypeBits(numeric_vtypes{});
+        } else if constexpr (std::is_same_v<T, std::tm> || std::is_same_v<T, std::chrono::system_clock::time_point>) {
+            return typeBit(VTYPE_TM) | typeBit(VTYPE_DATE);
+        } else if constexpr (std::is_same_v<T, std::u16string>) {
+            return typeBit(VTYPE_PWSTR) | (stringPolicy == StringPolicy::Utf16 ? typeBit(VTYPE_PSTR) : 0);
+        } else if constexpr (std::is_same_v<T, std::u16string_view>) {
+            return typeBit(VTYPE_PWSTR);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return typeBit(VTYPE_PSTR) | (stringPolicy == StringPolicy::Utf8 ? typeBit(VTYPE_PWSTR) : 0);
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            return typeBit(VTYPE_PSTR);
+        } else if constexpr (is_byte_vector_v<T> || std::is_same_v<T, BlobView> || is_byte_pointer_pair_v<T>) {
+            return typeBit(VTYPE_BLOB);
+        } else if constexpr (is_numeric_vector_v<T>) {
+            // Arrays are accepted as well but have no bit, being not scalar.
+            return typeBit(VTYPE_BLOB);
+        } else {
+            return 0;
+        }
+    }
+
+    // Type of the value, looking through VTYPE_VARIANT references.
+    TYPEVAR type() const noexcept
+    {
+        tVariant const* var = referent();
+        return var ? TV_VT(var) : TYPEVAR{VTYPE_EMPTY};
     }
 
 private:
+    // Bounds the chain of references followed, so a cyclic one is rejected rather than followed forever.
+    static constexpr int kMaxIndirection = 8;
+
     tVariant* pVar_{};
     IMemoryManager* memoryManager_{};
+    StringPolicy stringPolicy_{StringPolicy::AsIs};
+
+    // The variable holding the value: pVar_ itself, or the one a VTYPE_VARIANT (VTYPE_BYREF) variable points to in
+    // pvarVal. Null if the reference is empty or too deep.
+    tVariant* referent() const noexcept
+    {
+        tVariant* var = pVar_;
+        for (int depth = 0; var != nullptr && (TV_VT(var) & ~VTYPE_BYREF) == VTYPE_VARIANT; ++depth) {
+            if (depth == kMaxIndirection)
+                return nullptr;
+            var = var->pvarVal;
+        }
+        return var;
+    }
+
+    template<typename T>
+    bool readVariantAs(Variant& value) const
+    {
+        T alternative{};
+        if (!tryGetValue(alternative))
+            return false;
+
+        value = std::move(alternative);
+        return true;
+    }
+
+    bool readVariant(Variant& value) const
+    {
+        switch (TV_VT(pVar_)) {
+        case VTYPE_EMPTY:
+        case VTYPE_NULL: value = std::monostate{}; return true;
+        case VTYPE_BOOL: return readVariantAs<bool>(value);
+        case VTYPE_I1:
+        case VTYPE_I2:
+        case VTYPE_I4:
+        case VTYPE_INT:
+        case VTYPE_ERROR:
+        case VTYPE_UI1:
+        case VTYPE_UI2: return readVariantAs<int>(value);
+        case VTYPE_I8:
+        case VTYPE_UI4:
+        case VTYPE_UINT: return readVariantAs<std::int64_t>(value);
+        case VTYPE_UI8: return readVariantAs<std::int64_t>(value) || readVariantAs<double>(value);
+        case VTYPE_R4:
+        case VTYPE_R8: return readVariantAs<double>(value);
+        case VTYPE_TM:
+        case VTYPE_DATE: return readVariantAs<std::tm>(value);
+        // Strings are read in the type handlers work with.
+        case VTYPE_PWSTR:
+            return stringPolicy_ == StringPolicy::Utf8 ? readVariantAs<std::string>(value)
+                                                       : readVariantAs<std::u16string>(value);
+        case VTYPE_PSTR:
+            return stringPolicy_ == StringPolicy::Utf16 ? readVariantAs<std::u16string>(value)
+                                                        : readVariantAs<std::string>(value);
+        case VTYPE_BLOB: return readVariantAs<std::vector<unsigned char>>(value);
+        default: return false;
+        }
+    }
+
+    template<typename T, TYPEVAR... VTs>
+    bool readNumber(T& value, std::integer_sequence<TYPEVAR, VTs...>) const noexcept
+    {
+        const TYPEVAR vt = TV_VT(pVar_);
+        bool result = false;
+        (void)((vt == VTs && ((result = convertNumber(numeric_vtype<VTs>::of(*pVar_), value)), true)) || ...);
+        return result;
+    }
+
+    template<typename T, TYPEVAR... VTs>
+    bool writeNumberInPlace(T value, std::integer_sequence<TYPEVAR, VTs...>) noexcept
+    {
+        const TYPEVAR vt = TV_VT(pVar_);
+        bool result = false;
+        (void)((vt == VTs && ((result = convertNumber(value, numeric_vtype<VTs>::of(*pVar_))), true)) || ...);
+        return result;
+    }
+
+    // Either a packed blob (see setValue) copied at once, or a VTYPE_VECTOR/VTYPE_ARRAY of cbElements variants in
+    // pvarVal converted one by one.
+    template<typename T>
+    bool readNumericVector(T& value) const
+    {
+        using Element = typename T::value_type;
+
+        const TYPEVAR vt = TV_VT(pVar_);
+        if (vt == VTYPE_BLOB) {
+            if (pVar_->strLen % sizeof(Element) != 0)
+                return false;
+
+            value.resize(pVar_->strLen / sizeof(Element));
+            if (!value.empty()) {
+                memcpy(value.data(), pVar_->pstrVal, pVar_->strLen);
+                if constexpr (!kLittleEndian)
+                    swapElementBytes(value.data(), pVar_->strLen, sizeof(Element));
+            }
+            return true;
+        }
+
+        if ((vt & (VTYPE_VECTOR | VTYPE_ARRAY)) == 0 || (vt & VTYPE_BYREF) != 0)
+            return false;
+        if (pVar_->cbElements != 0 && pVar_->pvarVal == nullptr)
+            return false;
+
+        T result(pVar_->cbElements);
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            if (!ValueAccessor(&pVar_->pvarVal[i]).tryGetValue(result[i]))
+                return false;
+        }
+
+        value = std::move(result);
+        return true;
+    }
+
+    template<TYPEVAR... VTs>
+    static constexpr std::uint32_t numericTypeBits(std::integer_sequence<TYPEVAR, VTs...>) noexcept
+    {
+        return (typeBit(VTs) | ...);
+    }
+
+    // Overwrites a string or blob of the same type in place if the new value is not longer; returns false if the
+    // value should be stored anew. An unchanged value is left as is.
+    bool reuseBuffer(TYPEVAR vt, void const* data, std::size_t count, std::size_t unit) noexcept
+    {
+        if (TV_VT(pVar_) != vt || pVar_->pstrVal == nullptr)
+            return false;
+
+        const std::size_t current = vt == VTYPE_PWSTR ? pVar_->wstrLen : pVar_->strLen;
+        if (count > current)
+            return false;
+        if (count == current && memcmp(pVar_->pstrVal, data, count * unit) == 0)
+            return true;
+
+        memcpy(pVar_->pstrVal, data, count * unit);
+        if (vt == VTYPE_PWSTR) {
+            if (count < current)
+                pVar_->pwstrVal[count] = 0;
+            pVar_->wstrLen = count;
+        } else {
+            if (vt == VTYPE_PSTR && count < current)
+                pVar_->pstrVal[count] = 0;
+            pVar_->strLen = count;
+        }
+        return true;
+    }
+
+    void releaseBuffer() noexcept
+    {
+        const auto vt = TV_VT(pVar_);
+        if ((vt == VTYPE_PWSTR || vt == VTYPE_PSTR || vt == VTYPE_BLOB) && pVar_->pstrVal != nullptr && memoryManager_)
+            memoryManager_->FreeMemory(reinterpret_cast<void**>(&pVar_->pstrVal));
+    }
 
     std::tm secondsToTm(std::int64_t secondsFromEpoch) const
     {
@@ -77,6 +77,17 @@ public:
     using arg_type = typename std::tuple_element_t<I, args_tuple>;
 };
 
+template<typename T>
+struct member_class;
+
+template<typename C, typename M>
+struct member_class<M C::*> {
+    using type = C;
+};
+
+template<typename T>
+using member_class_t = typename member_class<T>::type;
+
 } // namespace c12cxx
 
 #endif // C12CXX_DETAILS_FUNCTIONTRAITS_H
@@ -1,7 +1,9 @@
 #ifndef C12CXX_DETAILS_UTFUTILS_H
 #define C12CXX_DETAILS_UTFUTILS_H
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace c12cxx {
 
@@ -9,6 +11,14 @@ std::string toUtf8(std::u16string_view utf16_sv);
 
 std::u16string toUtf16(std::string_view utf8_sv);
 
+// Number of UTF-16 code units toUtf16 makes of the text, counted without decoding it. Malformed input is detected
+// by the conversion only.
+std::size_t utf16Length(std::string_view utf8_sv) noexcept;
+
+// Converts into a buffer of at least utf16Length(utf8_sv) code units and returns the number written, so that the
+// result can be written straight into memory allocated for the host. Throws for malformed input like toUtf16.
+std::size_t toUtf16(std::string_view utf8_sv, char16_t* output, std::size_t capacity);
+
 bool isValidUtf8(std::string_view utf_sv);
 
 } // namespace c12cxx
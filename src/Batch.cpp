@@ -0,0 +1,304 @@
+#include <c12cxx/details/Batch.h>
+
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <c12cxx/details/NumericTypes.h>
+#include <c12cxx/details/api/IMemoryManager.h>
+#include <c12cxx/details/api/types.h>
+
+namespace c12cxx {
+
+namespace {
+
+static_assert(sizeof(int) == sizeof(std::int32_t), "VTYPE_INT and VTYPE_UINT are encoded as 32-bit numbers.");
+
+// The number held by a numeric variant, or nullptr for other types.
+template<typename Var, TYPEVAR... VTs>
+auto numberOf(Var& var, std::size_t& size, std::integer_sequence<TYPEVAR, VTs...>) noexcept
+{
+    std::conditional_t<std::is_const_v<Var>, void const*, void*> number = nullptr;
+    (void)((TV_VT(&var) == VTs &&
+            ((number = &numeric_vtype<VTs>::of(var)), (size = sizeof(numeric_vtype<VTs>::of(var))), true)) ||
+           ...);
+    if (TV_VT(&var) == VTYPE_DATE) {
+        number = &var.dblVal;
+        size = sizeof(var.dblVal);
+    }
+    return number;
+}
+
+} // namespace
+
+bool BatchWriter::supports(TYPEVAR vt) noexcept
+{
+    switch (vt) {
+    case VTYPE_EMPTY:
+    case VTYPE_NULL:
+    case VTYPE_BOOL:
+    case VTYPE_TM:
+    case VTYPE_PWSTR:
+    case VTYPE_PSTR:
+    case VTYPE_BLOB: return true;
+    default: {
+        tVariant var;
+        tVarInit(&var);
+        TV_VT(&var) = vt;
+        std::size_t size = 0;
+        return numberOf(var, size, numeric_vtypes{}) != nullptr;
+    }
+    }
+}
+
+void BatchWriter::writeCount(std::uint32_t count)
+{
+    writeNumber(&count, sizeof(count));
+}
+
+void BatchWriter::writeStatus(bool success)
+{
+    const std::uint8_t status = success ? 1 : 0;
+    writeBytes(&status, sizeof(status));
+}
+
+void BatchWriter::writeValue(tVariant const& value)
+{
+    switch (TV_VT(&value)) {
+    case VTYPE_EMPTY:
+    case VTYPE_NULL: writeType(TV_VT(&value)); break;
+    case VTYPE_BOOL: writeBool(value.bVal); break;
+    case VTYPE_TM: {
+        writeType(VTYPE_TM);
+        const std::int32_t fields[] = {value.tmVal.tm_year + 1900,
+                                       value.tmVal.tm_mon + 1,
+                                       value.tmVal.tm_mday,
+                                       value.tmVal.tm_hour,
+                                       value.tmVal.tm_min,
+                                       value.tmVal.tm_sec};
+        for (auto const field: fields)
+            writeNumber(&field, sizeof(field));
+        break;
+    }
+    case VTYPE_PWSTR:
+        writeString(std::u16string_view(reinterpret_cast<const char16_t*>(value.pwstrVal), value.wstrLen));
+        break;
+    case VTYPE_PSTR: writeString(std::string_view(value.pstrVal, value.strLen)); break;
+    case VTYPE_BLOB: writeBlob(std::string_view(value.pstrVal, value.strLen)); break;
+    default: {
+        std::size_t size = 0;
+        void const* number = numberOf(value, size, numeric_vtypes{});
+        if (number == nullptr)
+            throw std::invalid_argument("Unsupported value type in batch.");
+
+        writeType(TV_VT(&value));
+        writeNumber(number, size);
+    }
+    }
+}
+
+void BatchWriter::writeEmpty()
+{
+    writeType(VTYPE_EMPTY);
+}
+
+void BatchWriter::writeBool(bool value)
+{
+    writeType(VTYPE_BOOL);
+    const std::uint8_t byte = value ? 1 : 0;
+    writeBytes(&byte, sizeof(byte));
+}
+
+void BatchWriter::writeInt(std::int32_t value)
+{
+    writeType(VTYPE_I4);
+    writeNumber(&value, sizeof(value));
+}
+
+void BatchWriter::writeDouble(double value)
+{
+    writeType(VTYPE_R8);
+    writeNumber(&value, sizeof(value));
+}
+
+void BatchWriter::writeString(std::u16string_view value)
+{
+    writeType(VTYPE_PWSTR);
+    writeLength(value.size());
+    if constexpr (kLittleEndian) {
+        writeBytes(value.data(), value.size() * sizeof(char16_t));
+    } else {
+        for (auto const unit: value)
+            writeNumber(&unit, sizeof(unit));
+    }
+}
+
+void BatchWriter::writeString(std::string_view value)
+{
+    writeType(VTYPE_PSTR);
+    writeLength(value.size());
+    writeBytes(value.data(), value.size());
+}
+
+void BatchWriter::writeBlob(std::string_view value)
+{
+    writeType(VTYPE_BLOB);
+    writeLength(value.size());
+    writeBytes(value.data(), value.size());
+}
+
+void BatchWriter::writeType(TYPEVAR vt)
+{
+    const std::uint16_t type = vt;
+    writeNumber(&type, sizeof(type));
+}
+
+void BatchWriter::writeBytes(void const* bytes, std::size_t size)
+{
+    auto const* first = static_cast<char const*>(bytes);
+    data_.insert(data_.end(), first, first + size);
+}
+
+void BatchWriter::writeNumber(void const* number, std::size_t size)
+{
+    writeBytes(number, size);
+    if constexpr (!kLittleEndian)
+        swapElementBytes(&*(data_.end() - static_cast<std::ptrdiff_t>(size)), size, size);
+}
+
+void BatchWriter::writeLength(std::size_t size)
+{
+    if (size > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("Value is too long for batch.");
+
+    writeCount(static_cast<std::uint32_t>(size));
+}
+
+std::uint32_t BatchReader::readCount()
+{
+    std::uint32_t count = 0;
+    readNumber(&count, sizeof(count));
+    return count;
+}
+
+bool BatchReader::readStatus()
+{
+    std::uint8_t status = 0;
+    readBytes(&status, sizeof(status));
+    return status != 0;
+}
+
+void BatchReader::readValue(tVariant& var, IMemoryManager* memoryManager)
+{
+    std::uint16_t vt = 0;
+    readNumber(&vt, sizeof(vt));
+
+    tVarInit(&var);
+
+    switch (vt) {
+    case VTYPE_EMPTY:
+    case VTYPE_NULL: break;
+    case VTYPE_BOOL: {
+        std::uint8_t byte = 0;
+        readBytes(&byte, sizeof(byte));
+        var.bVal = byte != 0;
+        break;
+    }
+    case VTYPE_TM: {
+        std::int32_t fields[6] = {};
+        for (auto& field: fields)
+            readNumber(&field, sizeof(field));
+        var.tmVal.tm_year = fields[0] - 1900;
+        var.tmVal.tm_mon = fields[1] - 1;
+        var.tmVal.tm_mday = fields[2];
+        var.tmVal.tm_hour = fields[3];
+        var.tmVal.tm_min = fields[4];
+        var.tmVal.tm_sec = fields[5];
+        break;
+    }
+    case VTYPE_PWSTR:
+    case VTYPE_PSTR:
+    case VTYPE_BLOB: {
+        const std::uint32_t length = readCount();
+        const std::size_t unit = vt == VTYPE_PWSTR ? sizeof(char16_t) : 1;
+        if (static_cast<std::size_t>(end_ - pos_) / unit < length)
+            throw std::runtime_error("Malformed batch.");
+
+        // Strings are NUL-terminated like the ones passed by the host.
+        const std::size_t size = length * unit;
+        char* data = nullptr;
+        if (!memoryManager || !memoryManager->AllocMemory(reinterpret_cast<void**>(&data), size + unit) ||
+            data == nullptr)
+            throw std::bad_alloc();
+
+        std::memcpy(data, skipBytes(size), size);
+        std::memset(data + size, 0, unit);
+        if constexpr (!kLittleEndian)
+            swapElementBytes(data, size, unit);
+
+        if (vt == VTYPE_PWSTR) {
+            var.pwstrVal = reinterpret_cast<WCHAR_T*>(data);
+            var.wstrLen = length;
+        } else {
+            var.pstrVal = data;
+            var.strLen = length;
+        }
+        break;
+    }
+    default: {
+        TV_VT(&var) = vt;
+        std::size_t size = 0;
+        void* number = numberOf(var, size, numeric_vtypes{});
+        if (number == nullptr) {
+            tVarInit(&var);
+            throw std::runtime_error("Unsupported value type in batch.");
+        }
+
+        readNumber(number, size);
+    }
+    }
+
+    TV_VT(&var) = vt;
+}
+
+void BatchReader::readBytes(void* bytes, std::size_t size)
+{
+    std::memcpy(bytes, skipBytes(size), size);
+}
+
+void BatchReader::readNumber(void* number, std::size_t size)
+{
+    readBytes(number, size);
+    if constexpr (!kLittleEndian)
+        swapElementBytes(number, size, size);
+}
+
+void const* BatchReader::skipBytes(std::size_t size)
+{
+    if (static_cast<std::size_t>(end_ - pos_) < size)
+        throw std::runtime_error("Malformed batch.");
+
+    auto const* ret = pos_;
+    pos_ += size;
+    return ret;
+}
+
+void freeVariant(tVariant& var, IMemoryManager* memoryManager) noexcept
+{
+    switch (TV_VT(&var)) {
+    case VTYPE_PWSTR:
+    case VTYPE_PSTR:
+    case VTYPE_BLOB:
+        if (memoryManager && var.pstrVal)
+            memoryManager->FreeMemory(reinterpret_cast<void**>(&var.pstrVal));
+        break;
+    default: break;
+    }
+
+    tVarInit(&var);
+}
+
+} // namespace c12cxx
@@ -2,23 +2,81 @@
 
 #include <cstring>
 #include <locale>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <c12cxx/details/api/AddInDefBase.h>
 #include <c12cxx/details/api/ComponentBase.h>
 #include <c12cxx/details/api/IMemoryManager.h>
 #include <c12cxx/details/api/types.h>
 
+#include <c12cxx/details/Batch.h>
+#include <c12cxx/details/ParamSpan.h>
 #include <c12cxx/details/ValueAccessor.h>
 #include <c12cxx/details/utfutils.h>
 
 namespace c12cxx {
 
-Component::Component()
+Component::Component(): Component(baseMembers()) { }
+
+Component::Component(MemberTable const& typeMembers): typeMembers_(&typeMembers) { }
+
+MemberTable const& Component::baseMembers()
+{
+    static const MemberTable members = [] {
+        MemberTable ret;
+        ret.addProperty(u"HasError", u"ЕстьОшибка").withGetter(&Component::hasError);
+        ret.addProperty(u"ErrorMessage", u"ОписаниеОшибки").withGetter(&Component::errorMessage);
+        ret.addMethod(u"ClearError", u"ОчиститьОшибку").withHandler(&Component::clearError);
+        ret.addMethod(u"CallBatch", u"ВыполнитьПакет").withHandler(&Component::callBatch);
+        return ret;
+    }();
+    return members;
+}
+
+Property const* Component::property(long lPropNum) const noexcept
+{
+    auto const& shared = typeMembers_->properties();
+    auto const& own = ownMembers_.properties();
+
+    if (lPropNum < 0)
+        return nullptr;
+    if (static_cast<size_t>(lPropNum) < shared.size())
+        return &shared[lPropNum];
+    if (static_cast<size_t>(lPropNum) - shared.size() < own.size())
+        return &own[lPropNum - shared.size()];
+
+    return nullptr;
+}
+
+// Names come NUL-terminated from the name pool, so the terminator is copied along.
+WCHAR_T* Component::copyName(std::u16string_view name) const noexcept
 {
-    addProperty(u"HasError", u"ЕстьОшибка").withGetter(*this, &Component::hasError);
-    addProperty(u"ErrorMessage", u"ОписаниеОшибки").withGetter(*this, &Component::errorMessage);
-    addMethod(u"ClearError", u"ОчиститьОшибку").withHandler(*this, &Component::clearError);
+    WCHAR_T* ptr = nullptr;
+    const size_t size = (name.size() + 1) * sizeof(char16_t);
+    if ((memoryManager_ == nullptr) || !memoryManager_->AllocMemory(reinterpret_cast<void**>(&ptr), size) || ptr == nullptr) /*NOLINT*/
+        return nullptr;
+
+    std::memcpy(ptr, name.data(), size);
+
+    return ptr;
+}
+
+Method const* Component::method(long lMethodNum) const noexcept
+{
+    auto const& shared = typeMembers_->methods();
+    auto const& own = ownMembers_.methods();
+
+    if (lMethodNum < 0)
+        return nullptr;
+    if (static_cast<size_t>(lMethodNum) < shared.size())
+        return &shared[lMethodNum];
+    if (static_cast<size_t>(lMethodNum) - shared.size() < own.size())
+        return &own[lMethodNum - shared.size()];
+
+    return nullptr;
 }
 
 bool Component::Init(void* connection)
@@ -86,46 +144,41 @@ bool Component::RegisterExtensionAs(WCHAR_T** wsExtensionName)
 
 long Component::GetNProps()
 {
-    return static_cast<long>(properties_.size());
+    return static_cast<long>(properties().size());
 }
 
 long Component::FindProp(const WCHAR_T* wsPropName)
 {
-    std::u16string lookup_name{reinterpret_cast<const char16_t*>(wsPropName)}; /*NOLINT*/
-    for (size_t i = 0; i < properties_.size(); ++i)
-        if (properties_[i].nameIs(lookup_name))
-            return static_cast<long>(i);
+    const auto* name = reinterpret_cast<const char16_t*>(wsPropName); /*NOLINT*/
+
+    const long shared = typeMembers_->findProperty(name);
+    if (shared >= 0)
+        return shared;
 
-    return -1;
+    const long own = ownMembers_.findProperty(name);
+    return own < 0 ? own : own + static_cast<long>(typeMembers_->properties().size());
 }
 
 const WCHAR_T* Component::GetPropName(long lPropNum, long lPropAlias)
 {
-    if (lPropNum >= properties_.size())
+    if (property(lPropNum) == nullptr)
         return nullptr;
 
-    auto const& property = properties_[lPropNum];
-    std::u16string name = property.getName();
-    if (lPropAlias != 0)
-        name = property.getAlt();
-
-    WCHAR_T* ptr = nullptr;
-    const size_t size = (name.size() + 1) * sizeof(char16_t);
-    if ((memoryManager_ == nullptr) || !memoryManager_->AllocMemory(reinterpret_cast<void**>(&ptr), size) || ptr == nullptr) /*NOLINT*/
-        return nullptr;
-
-    std::memcpy(ptr, name.c_str(), size);
-
-    return ptr;
+    const auto shared = typeMembers_->properties().size();
+    const auto index = static_cast<size_t>(lPropNum);
+    const std::u16string_view name = index < shared ? typeMembers_->propertyName(index, lPropAlias != 0)
+                                                    : ownMembers_.propertyName(index - shared, lPropAlias != 0);
+    return copyName(name);
 }
 
 bool Component::GetPropVal(const long lPropNum, tVariant* pvarPropVal)
 {
-    if (lPropNum >= properties_.size())
+    auto const* prop = property(lPropNum);
+    if (prop == nullptr)
         return false;
 
     try {
-        return properties_[lPropNum].callGetter(ValueAccessor(pvarPropVal, memoryManager_));
+        return prop->callGetter(*this, ValueAccessor(pvarPropVal, memoryManager_, stringPolicy_));
     } catch (std::exception const& e) {
         setError(e.what());
     } catch (...) {
@@ -137,11 +190,13 @@ bool Component::GetPropVal(const long lPropNum, tVariant* pvarPropVal)
 
 bool Component::SetPropVal(const long lPropNum, tVariant* pvarPropVal)
 {
-    if (lPropNum >= properties_.size())
+    auto const* prop = property(lPropNum);
+    if (prop == nullptr)
         return false;
 
     try {
-        return properties_[lPropNum].callSetter(ValueAccessor(pvarPropVal));
+        checkUtf8(pvarPropVal, 1);
+        return prop->callSetter(*this, ValueAccessor(pvarPropVal, memoryManager_, stringPolicy_));
 
     } catch (std::exception const& e) {
         setError(e.what());
@@ -154,70 +209,62 @@ bool Component::SetPropVal(const long lPropNum, tVariant* pvarPropVal)
 
 bool Component::IsPropReadable(const long lPropNum)
 {
-    if (lPropNum >= properties_.size())
-        return false;
-
-    return properties_[lPropNum].isReadable();
+    auto const* prop = property(lPropNum);
+    return prop != nullptr && prop->isReadable();
 }
 
 bool Component::IsPropWritable(const long lPropNum)
 {
-    if (lPropNum >= properties_.size())
-        return false;
-
-    return properties_[lPropNum].isWritable();
+    auto const* prop = property(lPropNum);
+    return prop != nullptr && prop->isWritable();
 }
 
 long Component::GetNMethods()
 {
-    return static_cast<long>(methods_.size());
+    return static_cast<long>(methods().size());
 }
 
 long Component::FindMethod(const WCHAR_T* wsMethodName)
 {
-    std::u16string lookup_name{reinterpret_cast<const char16_t*>(wsMethodName)}; /*NOLINT*/
-    for (size_t i = 0; i < methods_.size(); ++i)
-        if (methods_[i].nameIs(lookup_name))
-            return static_cast<long>(i);
+    const auto* name = reinterpret_cast<const char16_t*>(wsMethodName); /*NOLINT*/
+
+    const long shared = typeMembers_->findMethod(name);
+    if (shared >= 0)
+        return shared;
 
-    return -1;
+    const long own = ownMembers_.findMethod(name);
+    return own < 0 ? own : own + static_cast<long>(typeMembers_->methods().size());
 }
 
 const WCHAR_T* Component::GetMethodName(const long lMethodNum, const long lMethodAlias)
 {
-    if (lMethodNum >= methods_.size())
-        return nullptr;
-
-    auto const& method = methods_[lMethodNum];
-    std::u16string name = method.getName();
-    if (lMethodAlias != 0)
-        name = method.getAlt();
-
-    WCHAR_T* ptr = nullptr;
-    const size_t size = (name.size() + 1) * sizeof(char16_t);
-    if ((memoryManager_ == nullptr) || !memoryManager_->AllocMemory(reinterpret_cast<void**>(&ptr), size) || ptr == nullptr) /*NOLINT*/
+    if (method(lMethodNum) == nullptr)
         return nullptr;
 
-    std::memcpy(ptr, name.c_str(), size);
-
-    return ptr;
+    const auto shared = typeMembers_->methods().size();
+    const auto index = static_cast<size_t>(lMethodNum);
+    const std::u16string_view name = index < shared ? typeMembers_->methodName(index, lMethodAlias != 0)
+                                                    : ownMembers_.methodName(index - shared, lMethodAlias != 0);
+    return copyName(name);
 }
 
 long Component::GetNParams(const long lMethodNum)
 {
-    if (lMethodNum >= methods_.size())
+    auto const* meth = method(lMethodNum);
+    if (meth == nullptr)
         return 0;
 
-    return static_cast<long>(methods_[lMethodNum].numberOfParams());
+    return static_cast<long>(meth->numberOfParams());
 }
 
 bool Component::GetParamDefValue(const long lMethodNum, const long lParamNum, tVariant* pvarParamDefValue)
 {
-    if (lMethodNum >= methods_.size())
+    auto const* meth = method(lMethodNum);
+    if (meth == nullptr)
         return false;
 
     try {
-        return methods_[lMethodNum].getParamDefValue(lParamNum, ValueAccessor(pvarParamDefValue, memoryManager_));
+        return meth->getParamDefValue(lParamNum, ValueAccessor(pvarParamDefValue, memoryManager_, stringPolicy_));
     } catch (std::exception const& e) {
         setError(e.what());
     } catch (...) {
@@ -229,28 +276,22 @@ bool Component::GetParamDefValue(const long lMethodNum, const long lParamNum, tV
 
 bool Component::HasRetVal(const long lMethodNum)
 {
-    if (lMethodNum >= methods_.size())
-        return false;
-
-    return methods_[lMethodNum].isFunction();
+    auto const* meth = method(lMethodNum);
+    return meth != nullptr && meth->isFunction();
 }
 
 bool Component::CallAsProc(const long lMethodNum, tVariant* paParams, const long lSizeArray)
 {
-    if (lMethodNum >= methods_.size() || (lSizeArray > 0 && paParams == nullptr))
+    auto const* meth = method(lMethodNum);
+    if (meth == nullptr || lSizeArray < 0 || (lSizeArray > 0 && paParams == nullptr))
         return false;
 
-    auto const& method = methods_[lMethodNum];
-    if (method.isFunction())
+    if (meth->isFunction())
         return false;
 
-    std::vector<ValueAccessor> params;
-    params.reserve(lSizeArray);
-    for (size_t i = 0; i < lSizeArray; ++i)
-        params.emplace_back(&(paParams[i]), memoryManager_);
-
     try {
-        return method.doCall(ValueAccessor(), params);
+        checkUtf8(paParams, static_cast<std::size_t>(lSizeArray));
+        return meth->doCall(*this, ValueAccessor(), ParamSpan(paParams, lSizeArray, memoryManager_, stringPolicy_));
     } catch (std::exception const& e) {
         setError(e.what());
     } catch (...) {
@@ -262,20 +303,18 @@ bool Component::CallAsProc(const long lMethodNum, tVariant* paParams, const long
 
 bool Component::CallAsFunc(const long lMethodNum, tVariant* pvarRetValue, tVariant* paParams, const long lSizeArray)
 {
-    if (lMethodNum >= methods_.size() || (lSizeArray > 0 && paParams == nullptr))
+    auto const* meth = method(lMethodNum);
+    if (meth == nullptr || lSizeArray < 0 || (lSizeArray > 0 && paParams == nullptr))
         return false;
 
-    auto const& method = methods_[lMethodNum];
-    if (!method.isFunction())
+    if (!meth->isFunction())
         return false;
 
-    std::vector<ValueAccessor> params;
-    params.reserve(lSizeArray);
-    for (size_t i = 0; i < lSizeArray; ++i)
-        params.emplace_back(&(paParams[i]), memoryManager_);
-
     try {
-        return method.doCall(ValueAccessor(pvarRetValue, memoryManager_), params);
+        checkUtf8(paParams, static_cast<std::size_t>(lSizeArray));
+        return meth->doCall(*this,
+                            ValueAccessor(pvarRetValue, memoryManager_, stringPolicy_),
+                            ParamSpan(paParams, lSizeArray, memoryManager_, stringPolicy_));
     } catch (std::exception const& e) {
         setError(e.what());
     } catch (...) {
@@ -285,6 +324,113 @@ bool Component::CallAsFunc(const long lMethodNum, tVariant* pvarRetValue, tVaria
     return false;
 }
 
+namespace {
+
+// Frees the strings and blobs held by the variants however the scope is left.
+class VariantsGuard {
+public:
+    VariantsGuard(std::vector<tVariant>& vars, IMemoryManager* memoryManager) noexcept:
+        vars_(vars),
+        memoryManager_(memoryManager)
+    { }
+
+    VariantsGuard(VariantsGuard const&) = delete;
+    VariantsGuard& operator=(VariantsGuard const&) = delete;
+
+    ~VariantsGuard() { release(); }
+
+    void release() noexcept
+    {
+        for (auto& var: vars_)
+            freeVariant(var, memoryManager_);
+    }
+
+private:
+    std::vector<tVariant>& vars_;
+    IMemoryManager* memoryManager_;
+};
+
+} // namespace
+
+std::vector<char> Component::callBatch(std::pair<const char*, const char*> batch)
+{
+    BatchReader reader(batch.first, batch.second);
+    BatchWriter writer;
+
+    const std::uint32_t count = reader.readCount();
+    writer.writeCount(count);
+
+    // Return value, method reference and arguments of the current call.
+    constexpr std::size_t kRet = 0;
+    constexpr std::size_t kRef = 1;
+    constexpr std::size_t kArgs = 2;
+    std::vector<tVariant> vars(kArgs);
+    VariantsGuard guard(vars, memoryManager_);
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        guard.release();
+        vars.resize(kArgs);
+
+        reader.readValue(vars[kRef], memoryManager_);
+        const std::uint32_t argc = reader.readCount();
+        if (argc > reader.maxValuesLeft())
+            throw std::runtime_error("Malformed batch.");
+        vars.resize(kArgs + argc);
+        for (std::uint32_t arg = 0; arg < argc; ++arg)
+            reader.readValue(vars[kArgs + arg], memoryManager_);
+
+        try {
+            Method const* meth = nullptr;
+            if (TV_VT(&vars[kRef]) == VTYPE_I4)
+                meth = method(vars[kRef].lVal);
+            else if (TV_VT(&vars[kRef]) == VTYPE_PWSTR)
+                meth = method(FindMethod(vars[kRef].pwstrVal));
+            if (meth == nullptr)
+                throw std::invalid_argument("Unknown method in batch.");
+
+            // Omitted trailing arguments get their default values, as the host would pass them.
+            for (std::size_t arg = argc; arg < meth->numberOfParams(); ++arg) {
+                vars.emplace_back();
+                meth->getParamDefValue(static_cast<long>(arg), ValueAccessor(&vars.back(), memoryManager_, stringPolicy_));
+            }
+
+            checkUtf8(vars.data() + kArgs, vars.size() - kArgs);
+            ParamSpan params(vars.data() + kArgs, vars.size() - kArgs, memoryManager_, stringPolicy_);
+            if (!meth->doCall(*this, ValueAccessor(&vars[kRet], memoryManager_, stringPolicy_), params))
+                throw std::runtime_error("Method call failed.");
+            if (!BatchWriter::supports(TV_VT(&vars[kRet])))
+                throw std::invalid_argument("Unsupported value type in batch.");
+
+            writer.writeStatus(true);
+            writer.writeValue(vars[kRet]);
+        } catch (std::exception const& e) {
+            writer.writeStatus(false);
+            writer.writeString(toUtf16(e.what()));
+        } catch (...) {
+            writer.writeStatus(false);
+            writer.writeString(u"CallBatch: unexpected error.");
+        }
+    }
+
+    if (!reader.atEnd())
+        throw std::runtime_error("Malformed batch.");
+
+    return writer.data();
+}
+
+void Component::checkUtf8(tVariant* vars, std::size_t count) const
+{
+    if (!validateUtf8_)
+        return;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        ValueAccessor value(&vars[i]);
+        std::string_view str;
+        if (value.type() == VTYPE_PSTR && value.tryGetValue(str) && !isValidUtf8(str))
+            throw std::invalid_argument("Invalid UTF-8 string.");
+    }
+}
+
 void Component::setError(std::string const& msg)
 {
     setError(toUtf16(msg));
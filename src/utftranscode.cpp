@@ -0,0 +1,725 @@
+#include "utftranscode.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define C12CXX_UTF_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define C12CXX_TARGET_AVX2
+#else
+#define C12CXX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace c12cxx::utf {
+
+namespace {
+
+// Scalar code shared by all the kernels: tails shorter than a vector and sequences the vector paths do not cover.
+// Malformed input is reported rather than repaired; the rules are those of utf8cpp (no overlong forms, surrogates
+// or code points beyond U+10FFFF).
+
+inline bool isTrail(unsigned char byte) noexcept
+{
+    return (byte & 0xC0) == 0x80;
+}
+
+inline bool decodeOne(unsigned char const*& in, unsigned char const* end, char16_t*& out) noexcept
+{
+    const std::uint32_t lead = in[0];
+    if (lead < 0x80) {
+        *out++ = static_cast<char16_t>(lead);
+        in += 1;
+        return true;
+    }
+
+    if (lead < 0xC2)
+        return false;
+
+    if (lead < 0xE0) {
+        if (end - in < 2 || !isTrail(in[1]))
+            return false;
+        *out++ = static_cast<char16_t>(((lead & 0x1F) << 6) | (in[1] & 0x3F));
+        in += 2;
+        return true;
+    }
+
+    if (lead < 0xF0) {
+        if (end - in < 3 || !isTrail(in[1]) || !isTrail(in[2]))
+            return false;
+        const std::uint32_t cp = ((lead & 0x0F) << 12) | ((in[1] & 0x3F) << 6) | (in[2] & 0x3F);
+        if (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))
+            return false;
+        *out++ = static_cast<char16_t>(cp);
+        in += 3;
+        return true;
+    }
+
+    if (lead < 0xF5) {
+        if (end - in < 4 || !isTrail(in[1]) || !isTrail(in[2]) || !isTrail(in[3]))
+            return false;
+        const std::uint32_t cp =
+            ((lead & 0x07) << 18) | ((in[1] & 0x3F) << 12) | ((in[2] & 0x3F) << 6) | (in[3] & 0x3F);
+        if (cp < 0x10000 || cp > 0x10FFFF)
+            return false;
+        *out++ = static_cast<char16_t>(0xD800 + ((cp - 0x10000) >> 10));
+        *out++ = static_cast<char16_t>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        in += 4;
+        return true;
+    }
+
+    return false;
+}
+
+inline bool encodeOne(char16_t const*& in, char16_t const* end, unsigned char*& out) noexcept
+{
+    std::uint32_t cp = in[0];
+    if (cp < 0x80) {
+        *out++ = static_cast<unsigned char>(cp);
+        in += 1;
+        return true;
+    }
+
+    if (cp < 0x800) {
+        *out++ = static_cast<unsigned char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        in += 1;
+        return true;
+    }
+
+    if (cp < 0xD800 || cp > 0xDFFF) {
+        *out++ = static_cast<unsigned char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        in += 1;
+        return true;
+    }
+
+    if (cp > 0xDBFF || end - in < 2 || in[1] < 0xDC00 || in[1] > 0xDFFF)
+        return false;
+
+    cp = 0x10000 + ((cp - 0xD800) << 10) + (in[1] - 0xDC00);
+    *out++ = static_cast<unsigned char>(0xF0 | (cp >> 18));
+    *out++ = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+    *out++ = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+    *out++ = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+    in += 2;
+    return true;
+}
+
+std::size_t utf8ToUtf16Tail(unsigned char const* in,
+                            unsigned char const* end,
+                            char16_t* out,
+                            char16_t const* output) noexcept
+{
+    while (in < end) {
+        if (!decodeOne(in, end, out))
+            return kInvalid;
+    }
+    return static_cast<std::size_t>(out - output);
+}
+
+std::size_t utf16ToUtf8Tail(char16_t const* in, char16_t const* end, unsigned char* out, char const* output) noexcept
+{
+    while (in < end) {
+        if (!encodeOne(in, end, out))
+            return kInvalid;
+    }
+    return static_cast<std::size_t>(out - reinterpret_cast<unsigned char const*>(output));
+}
+
+bool isValidUtf8Tail(unsigned char const* in, unsigned char const* end) noexcept
+{
+    char16_t scratch[2];
+    while (in < end) {
+        char16_t* out = scratch;
+        if (!decodeOne(in, end, out))
+            return false;
+    }
+    return true;
+}
+
+// Every byte other than a continuation one starts a code point, and a four-byte lead yields a surrogate pair.
+std::size_t utf16LengthTail(unsigned char const* in, unsigned char const* end) noexcept
+{
+    std::size_t length = 0;
+    for (; in < end; ++in)
+        length += static_cast<std::size_t>(!isTrail(*in)) + static_cast<std::size_t>(*in >= 0xF0);
+    return length;
+}
+
+// Three bytes per code unit but one for ASCII, two below U+0800 and two for each half of a surrogate pair.
+std::size_t utf8LengthTail(char16_t const* in, char16_t const* end) noexcept
+{
+    std::size_t length = 0;
+    for (; in < end; ++in)
+        length += *in < 0x80 ? 1 : *in < 0x800 || (*in >= 0xD800 && *in <= 0xDFFF) ? 2 : 3;
+    return length;
+}
+
+#ifdef C12CXX_UTF_X86_64
+
+inline unsigned countTrailingZeros(std::uint32_t value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index = 0;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+}
+
+// The vector loops run while a whole vector of input is left and the output has room for a whole vector of results:
+// a block is stored at once and the position advanced past the leading part that was converted, so a buffer of the
+// exact size is finished by the scalar code. ASCII text is widened or narrowed as is; runs of two-byte sequences (Cyrillic, Greek, Hebrew and so on)
+// are converted in place, one 16-bit lane per character.
+
+// Counts in byte lanes, each block adding at most two, and sums them up before they could overflow.
+std::size_t utf16LengthSse2(char const* input, std::size_t size) noexcept
+{
+    auto const* in = reinterpret_cast<unsigned char const*>(input);
+    auto const* end = in + size;
+    std::size_t length = 0;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lastTrail = _mm_set1_epi8(static_cast<char>(0xBF));
+    const __m128i fourByteBits = _mm_set1_epi8(static_cast<char>(0xF0));
+
+    while (end - in >= 16) {
+        __m128i counts = zero;
+        for (int i = 0; i < 127 && end - in >= 16; ++i, in += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+            // Continuation bytes are the smallest ones as signed, 0x80..0xBF.
+            counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(block, lastTrail));
+            counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(_mm_and_si128(block, fourByteBits), fourByteBits));
+        }
+
+        const __m128i sums = _mm_sad_epu8(counts, zero);
+        length += static_cast<std::size_t>(_mm_cvtsi128_si32(sums)) +
+                  static_cast<std::size_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+    }
+
+    return length + utf16LengthTail(in, end);
+}
+
+// Takes three bytes per code unit and counts what is saved in 16-bit lanes, each block adding at most two.
+std::size_t utf8LengthSse2(char16_t const* input, std::size_t size) noexcept
+{
+    char16_t const* in = input;
+    char16_t const* end = in + size;
+    std::size_t length = 0;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i beyondPairBits = _mm_set1_epi16(static_cast<short>(0xF800));
+    const __m128i surrogateBits = _mm_set1_epi16(static_cast<short>(0xD800));
+
+    while (end - in >= 8) {
+        __m128i saved = zero;
+        for (int i = 0; i < 8192 && end - in >= 8; ++i, in += 8) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+            const __m128i high = _mm_and_si128(block, beyondPairBits);
+            saved = _mm_sub_epi16(saved, _mm_cmpeq_epi16(_mm_and_si128(block, nonAsciiBits), zero));
+            saved = _mm_sub_epi16(saved, _mm_cmpeq_epi16(high, zero));
+            saved = _mm_sub_epi16(saved, _mm_cmpeq_epi16(high, surrogateBits));
+            length += 3 * 8;
+        }
+
+        __m128i sums = _mm_madd_epi16(saved, ones);
+        sums = _mm_add_epi32(sums, _mm_srli_si128(sums, 8));
+        sums = _mm_add_epi32(sums, _mm_srli_si128(sums, 4));
+        length -= static_cast<std::size_t>(_mm_cvtsi128_si32(sums));
+    }
+
+    return length + utf8LengthTail(in, end);
+}
+
+std::size_t utf8ToUtf16Sse2(char const* input, std::size_t size, char16_t* output, std::size_t capacity) noexcept
+{
+    auto const* in = reinterpret_cast<unsigned char const*>(input);
+    auto const* end = in + size;
+    char16_t* out = output;
+    char16_t const* outEnd = output + capacity;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i pairMask = _mm_set1_epi16(static_cast<short>(0xC0E0));
+    const __m128i pairPattern = _mm_set1_epi16(static_cast<short>(0x80C0));
+    const __m128i overlongMask = _mm_set1_epi16(0x001E);
+    const __m128i leadBits = _mm_set1_epi16(0x001F);
+    const __m128i trailBits = _mm_set1_epi16(0x003F);
+
+    while (end - in >= 16 && outEnd - out >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+        const auto nonAscii = static_cast<std::uint32_t>(_mm_movemask_epi8(block));
+        if ((nonAscii & 1) == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(block, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(block, zero));
+            const unsigned count = nonAscii == 0 ? 16 : countTrailingZeros(nonAscii);
+            in += count;
+            out += count;
+            continue;
+        }
+
+        // Lanes holding a lead byte C2..DF followed by a continuation byte.
+        const __m128i isPair = _mm_cmpeq_epi16(_mm_and_si128(block, pairMask), pairPattern);
+        const __m128i isOverlong = _mm_cmpeq_epi16(_mm_and_si128(block, overlongMask), zero);
+        const auto pairs = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_andnot_si128(isOverlong, isPair)));
+        if ((pairs & 1) != 0) {
+            const __m128i lead = _mm_slli_epi16(_mm_and_si128(block, leadBits), 6);
+            const __m128i trail = _mm_and_si128(_mm_srli_epi16(block, 8), trailBits);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_or_si128(lead, trail));
+            const unsigned count = pairs == 0xFFFF ? 8 : countTrailingZeros(~pairs) / 2;
+            in += 2 * count;
+            out += count;
+            continue;
+        }
+
+        if (!decodeOne(in, end, out))
+            return kInvalid;
+    }
+
+    return utf8ToUtf16Tail(in, end, out, output);
+}
+
+std::size_t utf16ToUtf8Sse2(char16_t const* input, std::size_t size, char* output, std::size_t capacity) noexcept
+{
+    char16_t const* in = input;
+    char16_t const* end = in + size;
+    auto* out = reinterpret_cast<unsigned char*>(output);
+    auto const* outEnd = out + capacity;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i beyondPairBits = _mm_set1_epi16(static_cast<short>(0xF800));
+    const __m128i leadPrefix = _mm_set1_epi16(0x00C0);
+    const __m128i trailBits = _mm_set1_epi16(0x003F);
+    const __m128i trailPrefix = _mm_set1_epi16(0x0080);
+
+    while (end - in >= 8 && outEnd - out >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+        const __m128i isAscii = _mm_cmpeq_epi16(_mm_and_si128(block, nonAsciiBits), zero);
+        const auto ascii = static_cast<std::uint32_t>(_mm_movemask_epi8(isAscii));
+        if ((ascii & 1) != 0) {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(block, block));
+            const unsigned count = ascii == 0xFFFF ? 8 : countTrailingZeros(~ascii) / 2;
+            in += count;
+            out += count;
+            continue;
+        }
+
+        const __m128i fitsPair = _mm_cmpeq_epi16(_mm_and_si128(block, beyondPairBits), zero);
+        const auto pairs = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_andnot_si128(isAscii, fitsPair)));
+        if ((pairs & 1) != 0) {
+            const __m128i lead = _mm_or_si128(_mm_srli_epi16(block, 6), leadPrefix);
+            const __m128i trail = _mm_slli_epi16(_mm_or_si128(_mm_and_si128(block, trailBits), trailPrefix), 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_or_si128(lead, trail));
+            const unsigned count = pairs == 0xFFFF ? 8 : countTrailingZeros(~pairs) / 2;
+            in += count;
+            out += 2 * count;
+            continue;
+        }
+
+        if (!encodeOne(in, end, out))
+            return kInvalid;
+    }
+
+    return utf16ToUtf8Tail(in, end, out, output);
+}
+
+C12CXX_TARGET_AVX2
+std::size_t utf8ToUtf16Avx2(char const* input, std::size_t size, char16_t* output, std::size_t capacity) noexcept
+{
+    auto const* in = reinterpret_cast<unsigned char const*>(input);
+    auto const* end = in + size;
+    char16_t* out = output;
+    char16_t const* outEnd = output + capacity;
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i pairMask = _mm256_set1_epi16(static_cast<short>(0xC0E0));
+    const __m256i pairPattern = _mm256_set1_epi16(static_cast<short>(0x80C0));
+    const __m256i overlongMask = _mm256_set1_epi16(0x001E);
+    const __m256i leadBits = _mm256_set1_epi16(0x001F);
+    const __m256i trailBits = _mm256_set1_epi16(0x003F);
+
+    while (end - in >= 32 && outEnd - out >= 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in));
+        const auto nonAscii = static_cast<std::uint32_t>(_mm256_movemask_epi8(block));
+        if ((nonAscii & 1) == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(block)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16),
+                                _mm256_cvtepu8_epi16(_mm256_extracti128_si256(block, 1)));
+            const unsigned count = nonAscii == 0 ? 32 : countTrailingZeros(nonAscii);
+            in += count;
+            out += count;
+            continue;
+        }
+
+        const __m256i isPair = _mm256_cmpeq_epi16(_mm256_and_si256(block, pairMask), pairPattern);
+        const __m256i isOverlong = _mm256_cmpeq_epi16(_mm256_and_si256(block, overlongMask), zero);
+        const auto pairs = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(isOverlong, isPair)));
+        if ((pairs & 1) != 0) {
+            const __m256i lead = _mm256_slli_epi16(_mm256_and_si256(block, leadBits), 6);
+            const __m256i trail = _mm256_and_si256(_mm256_srli_epi16(block, 8), trailBits);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_or_si256(lead, trail));
+            const unsigned count = pairs == 0xFFFFFFFF ? 16 : countTrailingZeros(~pairs) / 2;
+            in += 2 * count;
+            out += count;
+            continue;
+        }
+
+        if (!decodeOne(in, end, out))
+            return kInvalid;
+    }
+
+    return utf8ToUtf16Tail(in, end, out, output);
+}
+
+C12CXX_TARGET_AVX2
+std::size_t utf16ToUtf8Avx2(char16_t const* input, std::size_t size, char* output, std::size_t capacity) noexcept
+{
+    char16_t const* in = input;
+    char16_t const* end = in + size;
+    auto* out = reinterpret_cast<unsigned char*>(output);
+    auto const* outEnd = out + capacity;
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i nonAsciiBits = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    const __m256i beyondPairBits = _mm256_set1_epi16(static_cast<short>(0xF800));
+    const __m256i leadPrefix = _mm256_set1_epi16(0x00C0);
+    const __m256i trailBits = _mm256_set1_epi16(0x003F);
+    const __m256i trailPrefix = _mm256_set1_epi16(0x0080);
+
+    while (end - in >= 16 && outEnd - out >= 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in));
+        const __m256i isAscii = _mm256_cmpeq_epi16(_mm256_and_si256(block, nonAsciiBits), zero);
+        const auto ascii = static_cast<std::uint32_t>(_mm256_movemask_epi8(isAscii));
+        if ((ascii & 1) != 0) {
+            // Packing works within 128-bit lanes; gather the two packed halves into the low lane.
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(block, block), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+            const unsigned count = ascii == 0xFFFFFFFF ? 16 : countTrailingZeros(~ascii) / 2;
+            in += count;
+            out += count;
+            continue;
+        }
+
+        const __m256i fitsPair = _mm256_cmpeq_epi16(_mm256_and_si256(block, beyondPairBits), zero);
+        const auto pairs = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(isAscii, fitsPair)));
+        if ((pairs & 1) != 0) {
+            const __m256i lead = _mm256_or_si256(_mm256_srli_epi16(block, 6), leadPrefix);
+            const __m256i trail =
+                _mm256_slli_epi16(_mm256_or_si256(_mm256_and_si256(block, trailBits), trailPrefix), 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_or_si256(lead, trail));
+            const unsigned count = pairs == 0xFFFFFFFF ? 16 : countTrailingZeros(~pairs) / 2;
+            in += count;
+            out += 2 * count;
+            continue;
+        }
+
+        if (!encodeOne(in, end, out))
+            return kInvalid;
+    }
+
+    return utf16ToUtf8Tail(in, end, out, output);
+}
+
+// Validation after Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte": each byte is
+// classified together with the one before it by three 16-entry tables indexed with nibbles, whose entries are sets
+// of the errors the nibble is compatible with; a pair is malformed if all three agree on an error. Whether third
+// and fourth bytes of a sequence are continuation bytes is checked separately, by looking three bytes back. ASCII
+// blocks only need the previous block not to end inside a sequence.
+
+constexpr char kTooShort = 1 << 0;   // 11______ 0_______ / 11______ 11______
+constexpr char kTooLong = 1 << 1;    // 0_______ 10______
+constexpr char kOverlong3 = 1 << 2;  // 11100000 100_____
+constexpr char kTooLarge = 1 << 3;   // 11110100 1001____ / 11110100 101_____ / 11110101..11111111 1001____ ...
+constexpr char kSurrogate = 1 << 4;  // 11101101 101_____
+constexpr char kOverlong2 = 1 << 5;  // 1100000_ 10______
+constexpr char kTooLarge1000 = 1 << 6; // 11110101..11111111 1000____
+constexpr char kOverlong4 = 1 << 6;  // 11110000 1000____
+constexpr char kTwoConts = static_cast<char>(1 << 7); // 10______ 10______
+constexpr char kCarry = kTooShort | kTooLong | kTwoConts;
+
+C12CXX_TARGET_AVX2
+inline __m256i previousBytes(__m256i block, __m256i previous, int count) noexcept
+{
+    // The 128-bit lanes are shifted separately, so the upper lane of the previous block is put in front first.
+    const __m256i joined = _mm256_permute2x128_si256(previous, block, 0x21);
+    switch (count) {
+    case 1: return _mm256_alignr_epi8(block, joined, 15);
+    case 2: return _mm256_alignr_epi8(block, joined, 14);
+    default: return _mm256_alignr_epi8(block, joined, 13);
+    }
+}
+
+C12CXX_TARGET_AVX2
+inline __m256i lookup(__m256i table, __m256i nibbles) noexcept
+{
+    return _mm256_shuffle_epi8(table, nibbles);
+}
+
+C12CXX_TARGET_AVX2
+inline __m256i utf8Errors(__m256i block, __m256i previous) noexcept
+{
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    const __m256i firstHigh = _mm256_setr_epi8(
+        kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+        kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+        kTooShort | kOverlong2,
+        kTooShort,
+        kTooShort | kOverlong3 | kSurrogate,
+        kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+        kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+        kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+        kTooShort | kOverlong2,
+        kTooShort,
+        kTooShort | kOverlong3 | kSurrogate,
+        kTooShort | kTooLarge | kTooLarge1000 | kOverlong4);
+    const __m256i firstLow = _mm256_setr_epi8(
+        kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+        kCarry | kOverlong2,
+        kCarry,
+        kCarry,
+        kCarry | kTooLarge,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+        kCarry | kOverlong2,
+        kCarry,
+        kCarry,
+        kCarry | kTooLarge,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000);
+    constexpr char kContinuation1000 = kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4;
+    constexpr char kContinuation1001 = kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge;
+    constexpr char kContinuation101 = kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge;
+    const __m256i secondHigh = _mm256_setr_epi8(
+        kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+        kContinuation1000, kContinuation1001, kContinuation101, kContinuation101,
+        kTooShort, kTooShort, kTooShort, kTooShort,
+        kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+        kContinuation1000, kContinuation1001, kContinuation101, kContinuation101,
+        kTooShort, kTooShort, kTooShort, kTooShort);
+
+    const __m256i prev1 = previousBytes(block, previous, 1);
+    const __m256i special =
+        _mm256_and_si256(_mm256_and_si256(lookup(firstHigh, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibble)),
+                                          lookup(firstLow, _mm256_and_si256(prev1, lowNibble))),
+                         lookup(secondHigh, _mm256_and_si256(_mm256_srli_epi16(block, 4), lowNibble)));
+
+    // Only bytes after a three- or four-byte lead get the high bit here, and they must be continuation bytes,
+    // which the tables flag as kTwoConts.
+    const __m256i third = _mm256_subs_epu8(previousBytes(block, previous, 2), _mm256_set1_epi8(0xE0 - 0x80));
+    const __m256i fourth = _mm256_subs_epu8(previousBytes(block, previous, 3), _mm256_set1_epi8(0xF0 - 0x80));
+    const __m256i mustContinue =
+        _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(mustContinue, special);
+}
+
+// Non-zero where the block ends inside a sequence: a lead byte in one of the last three positions for which the
+// sequence does not fit.
+C12CXX_TARGET_AVX2
+inline __m256i incompleteAtEnd(__m256i block) noexcept
+{
+    const __m256i maxValue = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1),
+        static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+    return _mm256_subs_epu8(block, maxValue);
+}
+
+struct Utf8Check {
+    __m256i errors;
+    __m256i previous;
+    __m256i incomplete;
+};
+
+C12CXX_TARGET_AVX2
+inline void checkBlock(Utf8Check& check, __m256i block) noexcept
+{
+    if (_mm256_movemask_epi8(block) == 0) {
+        check.errors = _mm256_or_si256(check.errors, check.incomplete);
+    } else {
+        check.errors = _mm256_or_si256(check.errors, utf8Errors(block, check.previous));
+        check.incomplete = incompleteAtEnd(block);
+    }
+    check.previous = block;
+}
+
+C12CXX_TARGET_AVX2
+bool isValidUtf8Avx2(char const* input, std::size_t size) noexcept
+{
+    auto const* in = reinterpret_cast<unsigned char const*>(input);
+    auto const* end = in + size;
+
+    Utf8Check check{_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+    for (; end - in >= 32; in += 32)
+        checkBlock(check, _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in)));
+
+    // The tail is padded with ASCII, and one more ASCII block completes the check for a sequence cut off at the end.
+    alignas(32) unsigned char tail[32] = {};
+    std::memcpy(tail, in, static_cast<std::size_t>(end - in));
+    checkBlock(check, _mm256_load_si256(reinterpret_cast<__m256i const*>(tail)));
+    checkBlock(check, _mm256_setzero_si256());
+
+    return _mm256_testz_si256(check.errors, check.errors) != 0;
+}
+
+bool isValidUtf8Sse2(char const* input, std::size_t size) noexcept
+{
+    // Without a byte shuffle the tables cannot be looked up; ASCII runs are skipped a block at a time and
+    // everything else is decoded.
+    auto const* in = reinterpret_cast<unsigned char const*>(input);
+    auto const* end = in + size;
+    char16_t scratch[2];
+
+    while (end - in >= 16) {
+        const auto nonAscii =
+            static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in))));
+        if (nonAscii == 0) {
+            in += 16;
+            continue;
+        }
+
+        in += countTrailingZeros(nonAscii);
+        char16_t* out = scratch;
+        if (!decodeOne(in, end, out))
+            return false;
+    }
+
+    return isValidUtf8Tail(in, end);
+}
+
+bool hasAvx2() noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // AVX2 needs the OS to save the YMM registers as well.
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#else
+
+bool isValidUtf8Scalar(char const* input, std::size_t size) noexcept
+{
+    auto const* in = reinterpret_cast<unsigned char const*>(input);
+    return isValidUtf8Tail(in, in + size);
+}
+
+std::size_t utf16LengthScalar(char const* input, std::size_t size) noexcept
+{
+    auto const* in = reinterpret_cast<unsigned char const*>(input);
+    return utf16LengthTail(in, in + size);
+}
+
+std::size_t utf8LengthScalar(char16_t const* input, std::size_t size) noexcept
+{
+    return utf8LengthTail(input, input + size);
+}
+
+std::size_t utf8ToUtf16Scalar(char const* input, std::size_t size, char16_t* output, std::size_t) noexcept
+{
+    auto const* in = reinterpret_cast<unsigned char const*>(input);
+    return utf8ToUtf16Tail(in, in + size, output, output);
+}
+
+std::size_t utf16ToUtf8Scalar(char16_t const* input, std::size_t size, char* output, std::size_t) noexcept
+{
+    return utf16ToUtf8Tail(input, input + size, reinterpret_cast<unsigned char*>(output), output);
+}
+
+#endif // C12CXX_UTF_X86_64
+
+struct Kernels {
+    bool (*isValidUtf8)(char const* input, std::size_t size) noexcept;
+    std::size_t (*utf16Length)(char const* input, std::size_t size) noexcept;
+    std::size_t (*utf8Length)(char16_t const* input, std::size_t size) noexcept;
+    std::size_t (*utf8ToUtf16)(char const* input, std::size_t size, char16_t* output, std::size_t capacity) noexcept;
+    std::size_t (*utf16ToUtf8)(char16_t const* input, std::size_t size, char* output, std::size_t capacity) noexcept;
+};
+
+Kernels selectKernels() noexcept
+{
+#ifdef C12CXX_UTF_X86_64
+    if (hasAvx2())
+        return {&isValidUtf8Avx2, &utf16LengthSse2, &utf8LengthSse2, &utf8ToUtf16Avx2, &utf16ToUtf8Avx2};
+    return {&isValidUtf8Sse2, &utf16LengthSse2, &utf8LengthSse2, &utf8ToUtf16Sse2, &utf16ToUtf8Sse2};
+#else
+    return {&isValidUtf8Scalar, &utf16LengthScalar, &utf8LengthScalar, &utf8ToUtf16Scalar, &utf16ToUtf8Scalar};
+#endif
+}
+
+Kernels const& kernels() noexcept
+{
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+
+} // namespace
+
+bool isValidUtf8(char const* input, std::size_t size) noexcept
+{
+    return kernels().isValidUtf8(input, size);
+}
+
+std::size_t utf16Length(char const* input, std::size_t size) noexcept
+{
+    return kernels().utf16Length(input, size);
+}
+
+std::size_t utf8Length(char16_t const* input, std::size_t size) noexcept
+{
+    return kernels().utf8Length(input, size);
+}
+
+std::size_t utf8ToUtf16(char const* input, std::size_t size, char16_t* output, std::size_t capacity) noexcept
+{
+    return kernels().utf8ToUtf16(input, size, output, capacity);
+}
+
+std::size_t utf16ToUtf8(char16_t const* input, std::size_t size, char* output, std::size_t capacity) noexcept
+{
+    return kernels().utf16ToUtf8(input, size, output, capacity);
+}
+
+} // namespace c12cxx::utf
@@ -0,0 +1,30 @@
+#ifndef C12CXX_UTFTRANSCODE_H
+#define C12CXX_UTFTRANSCODE_H
+
+#include <cstddef>
+
+namespace c12cxx::utf {
+
+// Returned by the transcoders for malformed input.
+inline constexpr std::size_t kInvalid = static_cast<std::size_t>(-1);
+
+// Same rules as the transcoders: no overlong forms, surrogates or code points beyond U+10FFFF.
+bool isValidUtf8(char const* input, std::size_t size) noexcept;
+
+// Number of UTF-16 code units the UTF-8 text converts to. The input is not validated; for malformed input the
+// result is no less than what utf8ToUtf16 writes before it fails.
+std::size_t utf16Length(char const* input, std::size_t size) noexcept;
+
+// Number of UTF-8 bytes the UTF-16 text converts to, with the same guarantee for malformed input.
+std::size_t utf8Length(char16_t const* input, std::size_t size) noexcept;
+
+// Transcoders into a caller's buffer of the given capacity, which must hold the whole result: utf16Length code units
+// or utf8Length bytes. Return the number of code units written. Vectorized with the
+// best instruction set the CPU supports, which is detected once.
+std::size_t utf8ToUtf16(char const* input, std::size_t size, char16_t* output, std::size_t capacity) noexcept;
+
+std::size_t utf16ToUtf8(char16_t const* input, std::size_t size, char* output, std::size_t capacity) noexcept;
+
+} // namespace c12cxx::utf
+
+#endif // C12CXX_UTFTRANSCODE_H
@@ -1,28 +1,71 @@
 #include <c12cxx/details/utfutils.h>
 
 #include <iterator>
+#include <stdexcept>
 #include <string>
 
 #include "utf8.h"
+#include "utftranscode.h"
 
 namespace c12cxx {
+
+namespace {
+
+// Lets utf8cpp report malformed input with the exception it has always thrown.
+std::u16string utf8cppToUtf16(std::string_view utf8_sv)
+{
+    std::u16string utf16_str;
+    utf8::utf8to16(utf8_sv.begin(), utf8_sv.end(), std::back_inserter(utf16_str));
+    return utf16_str;
+}
+
+} // namespace
+
 std::string toUtf8(std::u16string_view utf16_sv)
 {
-    std::string utf8_str;
-    utf8::utf16to8(utf16_sv.begin(), utf16_sv.end(), std::back_inserter(utf8_str));
+    std::string utf8_str(utf::utf8Length(utf16_sv.data(), utf16_sv.size()), '\0');
+    const auto size = utf::utf16ToUtf8(utf16_sv.data(), utf16_sv.size(), utf8_str.data(), utf8_str.size());
+    if (size == utf::kInvalid) {
+        // Let utf8cpp report the error as before.
+        utf8_str.clear();
+        utf8::utf16to8(utf16_sv.begin(), utf16_sv.end(), std::back_inserter(utf8_str));
+        return utf8_str;
+    }
+
+    utf8_str.resize(size);
     return utf8_str;
 }
 
 std::u16string toUtf16(std::string_view utf8_sv)
 {
-    std::u16string utf16_str;
-    utf8::utf8to16(utf8_sv.begin(), utf8_sv.end(), std::back_inserter(utf16_str));
+    std::u16string utf16_str(utf::utf16Length(utf8_sv.data(), utf8_sv.size()), u'\0');
+    const auto size = utf::utf8ToUtf16(utf8_sv.data(), utf8_sv.size(), utf16_str.data(), utf16_str.size());
+    if (size == utf::kInvalid)
+        return utf8cppToUtf16(utf8_sv);
+
+    utf16_str.resize(size);
     return utf16_str;
 }
 
+std::size_t utf16Length(std::string_view utf8_sv) noexcept
+{
+    return utf::utf16Length(utf8_sv.data(), utf8_sv.size());
+}
+
+std::size_t toUtf16(std::string_view utf8_sv, char16_t* output, std::size_t capacity)
+{
+    const auto size = utf::utf8ToUtf16(utf8_sv.data(), utf8_sv.size(), output, capacity);
+    if (size == utf::kInvalid) {
+        utf8cppToUtf16(utf8_sv);
+        throw std::runtime_error("Invalid UTF-8 text.");
+    }
 
-bool isValidUtf8(std::string_view utf8_sv) {
-    return utf8::is_valid(utf8_sv.begin(), utf8_sv.end());
+    return size;
+}
+
+bool isValidUtf8(std::string_view utf8_sv)
+{
+    return utf::isValidUtf8(utf8_sv.data(), utf8_sv.size());
 }
 
 } // namespace c12cxx
@@ -0,0 +1,123 @@
+#include <c12cxx/details/HostWriter.h>
+#include <c12cxx/details/api/IMemoryManager.h>
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class CountingMemoryManager final: public IMemoryManager {
+public:
+    bool AllocMemory(void** pMemory, unsigned long ulCountByte) override
+    {
+        *pMemory = std::malloc(ulCountByte);
+        ++allocations;
+        lastSize = ulCountByte;
+        return *pMemory != nullptr;
+    }
+
+    void FreeMemory(void** pMemory) override
+    {
+        std::free(*pMemory);
+        *pMemory = nullptr;
+        ++frees;
+    }
+
+    int allocations{};
+    int frees{};
+    unsigned long lastSize{};
+};
+
+} // namespace
+
+TEST(HostWriter, growsGeometricallyAndHandsBufferOver)
+{
+    CountingMemoryManager mem;
+    c12cxx::HostStringWriter writer(&mem);
+
+    const std::u16string_view chunk{u"Строка отчета\n"};
+    constexpr int chunks = 10000;
+    for (int i = 0; i < chunks; ++i)
+        writer.append(chunk);
+
+    EXPECT_EQ(writer.size(), chunk.size() * chunks);
+    EXPECT_LT(mem.allocations, 30);
+    EXPECT_EQ(mem.frees, mem.allocations - 1);
+
+    const auto allocations = mem.allocations;
+    auto [data, size] = writer.release();
+    EXPECT_EQ(size, chunk.size() * chunks);
+    EXPECT_EQ(mem.allocations, allocations);
+    EXPECT_GE(mem.lastSize, (size + 1) * sizeof(char16_t));
+    EXPECT_EQ(data[size], 0);
+    EXPECT_EQ(std::u16string_view(data, chunk.size()), chunk);
+    EXPECT_EQ(writer.size(), 0);
+    EXPECT_EQ(writer.data(), nullptr);
+
+    mem.FreeMemory(reinterpret_cast<void**>(&data));
+    EXPECT_EQ(mem.frees, mem.allocations);
+}
+
+TEST(HostWriter, releasesExactReservation)
+{
+    CountingMemoryManager mem;
+    c12cxx::HostBlobWriter writer(&mem);
+
+    writer.reserve(3);
+    writer.push_back(1);
+    writer.push_back(2);
+    writer.push_back(3);
+
+    auto [data, size] = writer.release();
+    EXPECT_EQ(size, 3);
+    EXPECT_EQ(mem.allocations, 1);
+    EXPECT_EQ(data[2], 3);
+
+    mem.FreeMemory(reinterpret_cast<void**>(&data));
+}
+
+TEST(HostWriter, shrinksMostlyUnusedBuffer)
+{
+    CountingMemoryManager mem;
+    c12cxx::HostBlobWriter writer(&mem);
+
+    writer.reserve(1000);
+    writer.append(std::string_view{"data"});
+
+    auto [data, size] = writer.release();
+    EXPECT_EQ(size, 4);
+    EXPECT_EQ(mem.allocations, 2);
+    EXPECT_EQ(mem.lastSize, 4);
+    EXPECT_EQ(std::string_view(data, size), "data");
+
+    mem.FreeMemory(reinterpret_cast<void**>(&data));
+    EXPECT_EQ(mem.frees, mem.allocations);
+}
+
+TEST(HostWriter, freesUnreleasedBuffer)
+{
+    CountingMemoryManager mem;
+    {
+        c12cxx::HostBlobWriter writer(&mem);
+        writer.append(std::string_view{"data"});
+        c12cxx::HostBlobWriter moved(std::move(writer));
+    }
+    EXPECT_EQ(mem.allocations, 1);
+    EXPECT_EQ(mem.frees, 1);
+}
+
+TEST(HostWriter, emptyString)
+{
+    CountingMemoryManager mem;
+    c12cxx::HostStringWriter writer(&mem);
+
+    auto [data, size] = writer.release();
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(size, 0);
+    EXPECT_EQ(data[0], 0);
+
+    mem.FreeMemory(reinterpret_cast<void**>(&data));
+}
@@ -0,0 +1,72 @@
+#include <c12cxx/details/InplaceFunction.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+TEST(InplaceFunction, emptyByDefault)
+{
+    c12cxx::InplaceFunction<int(int)> fn;
+    EXPECT_FALSE(fn);
+
+    c12cxx::InplaceFunction<int(int)> null_fn{nullptr};
+    EXPECT_FALSE(null_fn);
+}
+
+TEST(InplaceFunction, callsStoredCallable)
+{
+    int base = 10;
+    c12cxx::InplaceFunction<int(int)> fn{[&base](int value) { return base + value; }};
+    ASSERT_TRUE(fn);
+    EXPECT_EQ(fn(5), 15);
+
+    base = 20;
+    EXPECT_EQ(fn(5), 25);
+}
+
+TEST(InplaceFunction, passesReferences)
+{
+    c12cxx::InplaceFunction<void(std::string&)> fn{[](std::string& str) { str += "!"; }};
+    std::string str{"test"};
+    fn(str);
+    EXPECT_EQ(str, "test!");
+}
+
+TEST(InplaceFunction, keepsMutableState)
+{
+    c12cxx::InplaceFunction<int()> fn{[counter = 0]() mutable { return ++counter; }};
+    EXPECT_EQ(fn(), 1);
+    EXPECT_EQ(fn(), 2);
+}
+
+TEST(InplaceFunction, copiesAndMovesCapture)
+{
+    auto shared = std::make_shared<int>(7);
+    c12cxx::InplaceFunction<int()> fn{[shared]() { return *shared; }};
+    EXPECT_EQ(shared.use_count(), 2);
+
+    c12cxx::InplaceFunction<int()> copy{fn};
+    EXPECT_EQ(shared.use_count(), 3);
+    EXPECT_EQ(copy(), 7);
+
+    c12cxx::InplaceFunction<int()> moved{std::move(copy)};
+    EXPECT_EQ(moved(), 7);
+    EXPECT_FALSE(copy); // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(shared.use_count(), 3);
+
+    copy = std::move(moved);
+    EXPECT_EQ(copy(), 7);
+    EXPECT_FALSE(moved); // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(shared.use_count(), 3);
+    moved = std::move(copy);
+
+    moved = nullptr;
+    EXPECT_FALSE(moved);
+    EXPECT_EQ(shared.use_count(), 2);
+
+    fn = c12cxx::InplaceFunction<int()>{[]() { return 1; }};
+    EXPECT_EQ(fn(), 1);
+    EXPECT_EQ(shared.use_count(), 1);
+}
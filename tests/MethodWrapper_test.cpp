@@ -1,9 +1,12 @@
 #include <c12cxx/details/MethodWrapper.h>
+#include <c12cxx/details/ParamSpan.h>
 #include <c12cxx/details/ValueAccessor.h>
 
 #include "test_utils.h"
 #include <c12cxx/details/api/types.h>
 
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -124,22 +127,143 @@ TEST_F(MethodWrapperFixture, doCall)
 
     EXPECT_EQ(TV_VT(&vars[4]), VTYPE_PWSTR);
     EXPECT_NE(vars[4].pwstrVal, nullptr);
-    EXPECT_NE(vars[4].pwstrVal, reinterpret_cast<WCHAR_T*>(u16TestString.data()));
+    EXPECT_EQ(vars[4].pwstrVal, reinterpret_cast<WCHAR_T*>(u16TestString.data()));
     EXPECT_EQ(vars[4].wstrLen, u16TestString.size());
     for (size_t i = 0; i < vars[4].wstrLen; ++i)
         EXPECT_EQ(vars[4].pwstrVal[i], u'1');
 
     EXPECT_EQ(TV_VT(&vars[5]), VTYPE_PSTR);
     EXPECT_NE(vars[5].pstrVal, nullptr);
-    EXPECT_NE(vars[5].pstrVal, reinterpret_cast<char*>(testString.data()));
+    EXPECT_EQ(vars[5].pstrVal, reinterpret_cast<char*>(testString.data()));
     EXPECT_EQ(vars[5].strLen, testString.size());
     for (size_t i = 0; i < vars[5].strLen; ++i)
         EXPECT_EQ(vars[5].pstrVal[i], '2');
 
     EXPECT_EQ(TV_VT(&vars[6]), VTYPE_BLOB);
     EXPECT_NE(vars[6].pstrVal, nullptr);
-    EXPECT_NE(vars[6].pstrVal, reinterpret_cast<char*>(testBlob.data()));
+    EXPECT_EQ(vars[6].pstrVal, reinterpret_cast<char*>(testBlob.data()));
     EXPECT_EQ(vars[6].strLen, testBlob.size());
     for (size_t i = 0; i < vars[6].strLen; ++i)
         EXPECT_EQ(vars[6].pstrVal[i], 3);
-}
\ No newline at end of file
+}
+TEST_F(MethodWrapperFixture, doCall_conversionError)
+{
+    tVariant vars[2];
+    tVarInit(&vars[0]);
+    TV_VT(&vars[0]) = VTYPE_I4;
+    vars[0].lVal = 1;
+    tVarInit(&vars[1]);
+    TV_VT(&vars[1]) = VTYPE_BOOL;
+    vars[1].bVal = true;
+
+    tVariant ret;
+    tVarInit(&ret);
+
+    bool called = false;
+    c12cxx::MethodWrapper wrapper{[&called](int a, std::u16string const& b) -> int {
+        called = true;
+        return a;
+    }};
+
+    try {
+        wrapper(c12cxx::ValueAccessor{&ret, &mem}, c12cxx::ParamSpan{vars, 2, &mem});
+        FAIL() << "Conversion error is not reported.";
+    } catch (std::runtime_error const& e) {
+        EXPECT_STREQ(e.what(), "Type conversion error: parameter 2.");
+    }
+
+    EXPECT_FALSE(called);
+    EXPECT_EQ(TV_VT(&ret), VTYPE_EMPTY);
+}
+
+TEST_F(MethodWrapperFixture, doCall_borrowsHostBuffers)
+{
+    std::u16string u16TestString{u"Строка длиннее буфера короткой строки"};
+    std::string testString{"String longer than the small string buffer"};
+    std::vector<char> testBlob{1, 2, 3};
+
+    tVariant vars[4];
+    tVarInit(&vars[0]);
+    TV_VT(&vars[0]) = VTYPE_PWSTR;
+    vars[0].pwstrVal = reinterpret_cast<WCHAR_T*>(u16TestString.data());
+    vars[0].wstrLen = u16TestString.size();
+
+    tVarInit(&vars[1]);
+    TV_VT(&vars[1]) = VTYPE_PSTR;
+    vars[1].pstrVal = testString.data();
+    vars[1].strLen = testString.size();
+
+    tVarInit(&vars[2]);
+    TV_VT(&vars[2]) = VTYPE_BLOB;
+    vars[2].pstrVal = testBlob.data();
+    vars[2].strLen = testBlob.size();
+
+    vars[3] = vars[0];
+
+    tVariant ret;
+    tVarInit(&ret);
+
+    const void* u16_data = nullptr;
+    const void* str_data = nullptr;
+    const void* blob_data = nullptr;
+    c12cxx::MethodWrapper wrapper{[&](std::u16string_view u16,
+                                      std::string_view const& str,
+                                      std::pair<const char*, const char*> blob,
+                                      std::u16string const& copy) {
+        u16_data = u16.data();
+        str_data = str.data();
+        blob_data = blob.first;
+    }};
+    EXPECT_TRUE(wrapper(c12cxx::ValueAccessor{&ret, &mem}, c12cxx::ParamSpan{vars, 4, &mem}));
+
+    EXPECT_EQ(u16_data, u16TestString.data());
+    EXPECT_EQ(str_data, testString.data());
+    EXPECT_EQ(blob_data, testBlob.data());
+
+    // Parameters taken by value or const reference are not written back.
+    EXPECT_EQ(vars[3].pwstrVal, reinterpret_cast<WCHAR_T*>(u16TestString.data()));
+}
+
+TEST_F(MethodWrapperFixture, doCall_updatesOutputParams)
+{
+    std::u16string shorter{u"Длинная строка"};
+    std::u16string longer{u"Строка"};
+    std::u16string unchanged{u"Строка"};
+
+    tVariant vars[4];
+    auto setString = [](tVariant& var, std::u16string& str) {
+        tVarInit(&var);
+        TV_VT(&var) = VTYPE_PWSTR;
+        var.pwstrVal = reinterpret_cast<WCHAR_T*>(str.data());
+        var.wstrLen = str.size();
+    };
+    setString(vars[0], shorter);
+    setString(vars[1], longer);
+    setString(vars[2], unchanged);
+    tVarInit(&vars[3]);
+    TV_VT(&vars[3]) = VTYPE_I2;
+    vars[3].lVal = 5;
+
+    tVariant ret;
+    tVarInit(&ret);
+
+    c12cxx::MethodWrapper wrapper{[](std::u16string& a, std::u16string& b, std::u16string& c, int& d) {
+        a = u"Строка";
+        b = u"Длинная строка";
+    }};
+    EXPECT_TRUE(wrapper(c12cxx::ValueAccessor{&ret, &mem}, c12cxx::ParamSpan{vars, 4, &mem}));
+
+    // A value that fits is written into the host buffer.
+    EXPECT_EQ(vars[0].pwstrVal, reinterpret_cast<WCHAR_T*>(shorter.data()));
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(vars[0].pwstrVal)), u"Строка");
+    EXPECT_EQ(vars[0].wstrLen, 6);
+
+    // A longer one gets a new buffer.
+    EXPECT_NE(vars[1].pwstrVal, reinterpret_cast<WCHAR_T*>(longer.data()));
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(vars[1].pwstrVal), vars[1].wstrLen), u"Длинная строка");
+    EXPECT_EQ(longer, u"Строка");
+
+    // Unchanged values are not written at all.
+    EXPECT_EQ(vars[2].pwstrVal, reinterpret_cast<WCHAR_T*>(unchanged.data()));
+    EXPECT_EQ(TV_VT(&vars[3]), VTYPE_I2);
+}
@@ -5,10 +5,15 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
+#include <limits>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -105,27 +110,60 @@ TEST_F(ValueAccessorFixture, read_BOOL)
                           std::pair<char*, char*>>(&var);
 }
 
-TEST_F(ValueAccessorFixture, read_I2_I4_ERROR_UI1)
+TEST_F(ValueAccessorFixture, read_integers)
 {
     tVariant var;
+    tVarInit(&var);
     c12cxx::ValueAccessor v(&var);
 
+    TV_VT(&var) = VTYPE_I1;
+    var.i8Val = -77;
+    EXPECT_EQ(v.getValue<int>(), -77);
+    EXPECT_EQ(v.getValue<double>(), -77.0);
+
     TV_VT(&var) = VTYPE_I2;
-    var.lVal = 777;
-    EXPECT_EQ(v.getValue<int>(), var.lVal);
-    EXPECT_EQ(v.getValue<double>(), var.lVal);
+    var.shortVal = -777;
+    EXPECT_EQ(v.getValue<int>(), -777);
+    EXPECT_EQ(v.getValue<double>(), -777.0);
 
     TV_VT(&var) = VTYPE_I4;
-    EXPECT_EQ(v.getValue<int>(), var.lVal);
-    EXPECT_EQ(v.getValue<double>(), var.lVal);
+    var.lVal = 777;
+    EXPECT_EQ(v.getValue<int>(), 777);
+    EXPECT_EQ(v.getValue<double>(), 777.0);
 
     TV_VT(&var) = VTYPE_ERROR;
-    EXPECT_EQ(v.getValue<int>(), var.lVal);
-    EXPECT_EQ(v.getValue<double>(), var.lVal);
+    var.errCode = 777;
+    EXPECT_EQ(v.getValue<int>(), 777);
+
+    TV_VT(&var) = VTYPE_I8;
+    var.llVal = -7'777'777'777'777;
+    EXPECT_EQ(v.getValue<std::int64_t>(), -7'777'777'777'777);
+    EXPECT_EQ(v.getValue<double>(), -7'777'777'777'777.0);
 
     TV_VT(&var) = VTYPE_UI1;
-    EXPECT_EQ(v.getValue<int>(), var.lVal);
-    EXPECT_EQ(v.getValue<double>(), var.lVal);
+    var.ui8Val = 200;
+    EXPECT_EQ(v.getValue<int>(), 200);
+
+    TV_VT(&var) = VTYPE_UI2;
+    var.ushortVal = 60000;
+    EXPECT_EQ(v.getValue<int>(), 60000);
+
+    TV_VT(&var) = VTYPE_UI4;
+    var.ulVal = 4'000'000'000;
+    EXPECT_EQ(v.getValue<std::uint32_t>(), 4'000'000'000u);
+    EXPECT_EQ(v.getValue<std::int64_t>(), 4'000'000'000);
+
+    TV_VT(&var) = VTYPE_UI8;
+    var.ullVal = 18'000'000'000'000'000'000u;
+    EXPECT_EQ(v.getValue<std::uint64_t>(), 18'000'000'000'000'000'000u);
+
+    TV_VT(&var) = VTYPE_INT;
+    var.intVal = -777;
+    EXPECT_EQ(v.getValue<int>(), -777);
+
+    TV_VT(&var) = VTYPE_UINT;
+    var.uintVal = 777;
+    EXPECT_EQ(v.getValue<int>(), 777);
 
     expectThrowOnGetValue<bool,
                           std::tm,
@@ -141,17 +179,19 @@ TEST_F(ValueAccessorFixture, read_I2_I4_ERROR_UI1)
 TEST_F(ValueAccessorFixture, read_R4_R8)
 {
     tVariant var;
+    tVarInit(&var);
     c12cxx::ValueAccessor v(&var);
 
     TV_VT(&var) = VTYPE_R8;
     var.dblVal = 777.0;
-    EXPECT_EQ(v.getValue<double>(), var.dblVal);
-    EXPECT_EQ(v.getValue<int>(), var.dblVal);
+    EXPECT_EQ(v.getValue<double>(), 777.0);
+    EXPECT_EQ(v.getValue<int>(), 777);
 
     TV_VT(&var) = VTYPE_R4;
-    var.dblVal = 777.0;
-    EXPECT_EQ(v.getValue<double>(), var.dblVal);
-    EXPECT_EQ(v.getValue<int>(), var.dblVal);
+    var.fltVal = 777.0f;
+    EXPECT_EQ(v.getValue<double>(), 777.0);
+    EXPECT_EQ(v.getValue<float>(), 777.0f);
+    EXPECT_EQ(v.getValue<int>(), 777);
 
     expectThrowOnGetValue<bool,
                           std::tm,
@@ -164,6 +204,37 @@ TEST_F(ValueAccessorFixture, read_R4_R8)
                           std::pair<char*, char*>>(&var);
 }
 
+TEST_F(ValueAccessorFixture, readNumberOutOfRange)
+{
+    tVariant var;
+    tVarInit(&var);
+    c12cxx::ValueAccessor v(&var);
+
+    TV_VT(&var) = VTYPE_I8;
+    var.llVal = std::int64_t{1} << 40;
+    EXPECT_THROW(v.getValue<int>(), std::runtime_error);
+    EXPECT_EQ(v.getValue<std::int64_t>(), std::int64_t{1} << 40);
+
+    TV_VT(&var) = VTYPE_I4;
+    var.lVal = -1;
+    EXPECT_THROW(v.getValue<unsigned int>(), std::runtime_error);
+    EXPECT_THROW(v.getValue<std::uint64_t>(), std::runtime_error);
+
+    TV_VT(&var) = VTYPE_UI8;
+    var.ullVal = std::numeric_limits<std::uint64_t>::max();
+    EXPECT_THROW(v.getValue<std::int64_t>(), std::runtime_error);
+
+    TV_VT(&var) = VTYPE_R8;
+    var.dblVal = 1.5;
+    EXPECT_THROW(v.getValue<int>(), std::runtime_error);
+    var.dblVal = 1e20;
+    EXPECT_THROW(v.getValue<std::int64_t>(), std::runtime_error);
+    var.dblVal = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_THROW(v.getValue<int>(), std::runtime_error);
+    var.dblVal = 1e300;
+    EXPECT_THROW(v.getValue<float>(), std::runtime_error);
+}
+
 TEST_F(ValueAccessorFixture, read_TM)
 {
     tVariant var;
@@ -280,6 +351,10 @@ TEST_F(ValueAccessorFixture, read_BLOB)
     auto [begin, end] = v.getValue<std::pair<const char*, const char*>>();
     EXPECT_TRUE(std::equal(begin, end, test.begin()));
 
+    auto view = v.getValue<c12cxx::BlobView>();
+    EXPECT_EQ(static_cast<const void*>(view.data()), static_cast<const void*>(test.data()));
+    EXPECT_EQ(view.size(), test.size());
+
     expectThrowOnGetValue<bool,
                           int,
                           double,
@@ -291,6 +366,201 @@ TEST_F(ValueAccessorFixture, read_BLOB)
                           std::string_view>(&var);
 }
 
+TEST_F(ValueAccessorFixture, read_numericVector)
+{
+    tVariant var;
+    tVarInit(&var);
+    c12cxx::ValueAccessor v(&var);
+
+    std::vector<std::int64_t> packed{1, -2, std::int64_t{1} << 40};
+    TV_VT(&var) = VTYPE_BLOB;
+    var.pstrVal = reinterpret_cast<char*>(packed.data());
+    var.strLen = packed.size() * sizeof(std::int64_t);
+    EXPECT_EQ(v.getValue<std::vector<std::int64_t>>(), packed);
+    EXPECT_EQ(v.getValue<std::vector<std::int32_t>>().size(), 6);
+    var.strLen = 3;
+    EXPECT_THROW(v.getValue<std::vector<std::int32_t>>(), std::runtime_error);
+
+    tVariant elements[3];
+    for (auto& element: elements)
+        tVarInit(&element);
+    TV_VT(&elements[0]) = VTYPE_I4;
+    elements[0].lVal = 1;
+    TV_VT(&elements[1]) = VTYPE_R8;
+    elements[1].dblVal = 2.0;
+    TV_VT(&elements[2]) = VTYPE_I8;
+    elements[2].llVal = 3;
+
+    tVarInit(&var);
+    TV_VT(&var) = VTYPE_VECTOR | VTYPE_VARIANT;
+    var.pvarVal = elements;
+    var.cbElements = 3;
+    EXPECT_EQ(v.getValue<std::vector<std::int32_t>>(), (std::vector<std::int32_t>{1, 2, 3}));
+    EXPECT_EQ(v.getValue<std::vector<double>>(), (std::vector<double>{1.0, 2.0, 3.0}));
+
+    TV_VT(&var) = VTYPE_ARRAY | VTYPE_VARIANT;
+    elements[1].dblVal = 2.5;
+    EXPECT_THROW(v.getValue<std::vector<std::int32_t>>(), std::runtime_error);
+    EXPECT_EQ(v.getValue<std::vector<double>>(), (std::vector<double>{1.0, 2.5, 3.0}));
+}
+
+TEST_F(ValueAccessorFixture, read_variant)
+{
+    tVariant var;
+    tVarInit(&var);
+    c12cxx::ValueAccessor v(&var);
+
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(v.getValue<c12cxx::Variant>()));
+
+    TV_VT(&var) = VTYPE_BOOL;
+    var.bVal = true;
+    EXPECT_EQ(v.getValue<c12cxx::Variant>(), c12cxx::Variant{true});
+
+    TV_VT(&var) = VTYPE_I2;
+    var.shortVal = -7;
+    EXPECT_EQ(v.getValue<c12cxx::Variant>(), c12cxx::Variant{-7});
+
+    TV_VT(&var) = VTYPE_I8;
+    var.llVal = std::int64_t{1} << 40;
+    EXPECT_EQ(v.getValue<c12cxx::Variant>(), c12cxx::Variant{std::int64_t{1} << 40});
+
+    TV_VT(&var) = VTYPE_UI8;
+    var.ullVal = std::numeric_limits<std::uint64_t>::max();
+    EXPECT_TRUE(std::holds_alternative<double>(v.getValue<c12cxx::Variant>()));
+
+    TV_VT(&var) = VTYPE_R4;
+    var.fltVal = 0.5f;
+    EXPECT_EQ(v.getValue<c12cxx::Variant>(), c12cxx::Variant{0.5});
+
+    std::u16string wide{u"Test"};
+    TV_VT(&var) = VTYPE_PWSTR;
+    var.pwstrVal = reinterpret_cast<WCHAR_T*>(wide.data());
+    var.wstrLen = wide.size();
+    EXPECT_EQ(v.getValue<c12cxx::Variant>(), c12cxx::Variant{wide});
+
+    std::string narrow{"Test"};
+    TV_VT(&var) = VTYPE_PSTR;
+    var.pstrVal = narrow.data();
+    var.strLen = narrow.size();
+    EXPECT_EQ(v.getValue<c12cxx::Variant>(), c12cxx::Variant{narrow});
+
+    TV_VT(&var) = VTYPE_BLOB;
+    const std::vector<unsigned char> bytes(narrow.begin(), narrow.end());
+    EXPECT_EQ(v.getValue<c12cxx::Variant>(), c12cxx::Variant{bytes});
+
+    TV_VT(&var) = VTYPE_CLSID;
+    EXPECT_THROW(v.getValue<c12cxx::Variant>(), std::runtime_error);
+}
+
+TEST_F(ValueAccessorFixture, read_reference)
+{
+    tVariant referred;
+    tVarInit(&referred);
+    TV_VT(&referred) = VTYPE_I4;
+    referred.lVal = 42;
+
+    tVariant var;
+    tVarInit(&var);
+    TV_VT(&var) = VTYPE_VARIANT;
+    var.pvarVal = &referred;
+    c12cxx::ValueAccessor v(&var);
+
+    EXPECT_EQ(v.type(), VTYPE_I4);
+    EXPECT_EQ(v.getValue<int>(), 42);
+    EXPECT_EQ(v.getValue<c12cxx::Variant>(), c12cxx::Variant{42});
+
+    TV_VT(&var) = VTYPE_VARIANT | VTYPE_BYREF;
+    EXPECT_EQ(v.getValue<int>(), 42);
+
+    var.pvarVal = nullptr;
+    EXPECT_THROW(v.getValue<int>(), std::runtime_error);
+
+    var.pvarVal = &var;
+    EXPECT_THROW(v.getValue<c12cxx::Variant>(), std::runtime_error);
+}
+
+TEST_F(ValueAccessorFixture, read_optional)
+{
+    tVariant var;
+    tVarInit(&var);
+    c12cxx::ValueAccessor v(&var, &mem);
+
+    std::optional<int> value{1};
+    EXPECT_TRUE(v.tryGetValue(value));
+    EXPECT_FALSE(value.has_value());
+
+    TV_VT(&var) = VTYPE_I4;
+    var.lVal = 42;
+    EXPECT_EQ(v.getValue<std::optional<int>>(), 42);
+    EXPECT_THROW(v.getValue<std::optional<std::u16string>>(), std::runtime_error);
+
+    v.setValue(std::optional<int>{});
+    EXPECT_EQ(TV_VT(&var), VTYPE_EMPTY);
+    v.updateValue(std::optional<int>{7});
+    EXPECT_EQ(TV_VT(&var), VTYPE_I4);
+    EXPECT_EQ(var.lVal, 7);
+}
+
+TEST_F(ValueAccessorFixture, tryGetValue)
+{
+    tVariant var;
+    tVarInit(&var);
+    TV_VT(&var) = VTYPE_I4;
+    var.lVal = 42;
+    c12cxx::ValueAccessor v(&var);
+
+    int number = 0;
+    EXPECT_TRUE(v.tryGetValue(number));
+    EXPECT_EQ(number, 42);
+
+    std::u16string str{u"unchanged"};
+    EXPECT_FALSE(v.tryGetValue(str));
+    EXPECT_EQ(str, u"unchanged");
+
+    bool flag = false;
+    EXPECT_NO_THROW(EXPECT_FALSE(c12cxx::ValueAccessor().tryGetValue(flag)));
+}
+
+TEST_F(ValueAccessorFixture, acceptedTypesMatchTryGetValue)
+{
+    auto check = [this](auto typeTag) {
+        using T = decltype(typeTag);
+        for (auto const policy: {c12cxx::StringPolicy::AsIs, c12cxx::StringPolicy::Utf8, c12cxx::StringPolicy::Utf16}) {
+            for (TYPEVAR vt = 0; vt < c12cxx::kScalarTypeCount; ++vt) {
+                tVariant var;
+                tVarInit(&var);
+                TV_VT(&var) = vt;
+                if (vt == VTYPE_DATE)
+                    var.dblVal = 62636712356;
+
+                T value{};
+                const bool accepted = (c12cxx::ValueAccessor::acceptedTypes<T>(policy) & c12cxx::typeBit(vt)) != 0;
+                EXPECT_EQ(c12cxx::ValueAccessor(&var, &mem, policy).tryGetValue(value), accepted)
+                    << "vt = " << vt << ", policy = " << static_cast<int>(policy);
+            }
+        }
+    };
+
+    check(bool{});
+    check(int{});
+    check(std::int64_t{});
+    check(std::uint8_t{});
+    check(float{});
+    check(double{});
+    check(std::tm{});
+    check(std::chrono::system_clock::time_point{});
+    check(std::u16string{});
+    check(std::u16string_view{});
+    check(std::string{});
+    check(std::string_view{});
+    check(std::vector<char>{});
+    check(std::pair<char*, char*>{});
+    check(c12cxx::BlobView{});
+    check(std::vector<double>{});
+    check(c12cxx::Variant{});
+    check(std::optional<int>{});
+}
+
 TEST_F(ValueAccessorFixture, writeBool)
 {
     tVariant var;
@@ -313,6 +583,71 @@ TEST_F(ValueAccessorFixture, writeInt)
     EXPECT_EQ(var.lVal, 777);
 }
 
+TEST_F(ValueAccessorFixture, writeSizedIntegers)
+{
+    tVariant var;
+    tVarInit(&var);
+    c12cxx::ValueAccessor v(&var);
+
+    v.setValue(std::int64_t{-7'777'777'777'777});
+    EXPECT_EQ(TV_VT(&var), VTYPE_I8);
+    EXPECT_EQ(var.llVal, -7'777'777'777'777);
+
+    v.setValue(std::uint64_t{18'000'000'000'000'000'000u});
+    EXPECT_EQ(TV_VT(&var), VTYPE_UI8);
+    EXPECT_EQ(var.ullVal, 18'000'000'000'000'000'000u);
+
+    v.setValue(std::int16_t{-777});
+    EXPECT_EQ(TV_VT(&var), VTYPE_I2);
+    EXPECT_EQ(var.shortVal, -777);
+
+    v.setValue(std::uint8_t{200});
+    EXPECT_EQ(TV_VT(&var), VTYPE_UI1);
+    EXPECT_EQ(var.ui8Val, 200);
+
+    v.setValue(0.5f);
+    EXPECT_EQ(TV_VT(&var), VTYPE_R4);
+    EXPECT_EQ(var.fltVal, 0.5f);
+}
+
+TEST_F(ValueAccessorFixture, updateValueKeepsNumberType)
+{
+    tVariant var;
+    tVarInit(&var);
+    TV_VT(&var) = VTYPE_R8;
+    var.dblVal = 1.0;
+    c12cxx::ValueAccessor v(&var);
+
+    v.updateValue(2);
+    EXPECT_EQ(TV_VT(&var), VTYPE_R8);
+    EXPECT_EQ(var.dblVal, 2.0);
+
+    TV_VT(&var) = VTYPE_I2;
+    var.shortVal = 1;
+    v.updateValue(100'000);
+    EXPECT_EQ(TV_VT(&var), VTYPE_I4);
+    EXPECT_EQ(var.lVal, 100'000);
+}
+
+TEST_F(ValueAccessorFixture, writeVariant)
+{
+    tVariant var;
+    tVarInit(&var);
+    c12cxx::ValueAccessor v(&var, &mem);
+
+    v.setValue(c12cxx::Variant{std::u16string{u"Test"}});
+    EXPECT_EQ(TV_VT(&var), VTYPE_PWSTR);
+    EXPECT_EQ(v.getValue<std::u16string>(), u"Test");
+    mem.FreeMemory(reinterpret_cast<void**>(&var.pwstrVal));
+
+    v.setValue(c12cxx::Variant{std::int64_t{7}});
+    EXPECT_EQ(TV_VT(&var), VTYPE_I8);
+    EXPECT_EQ(var.llVal, 7);
+
+    v.setValue(c12cxx::Variant{});
+    EXPECT_EQ(TV_VT(&var), VTYPE_EMPTY);
+}
+
 TEST_F(ValueAccessorFixture, writeDouble)
 {
     tVariant var;
@@ -421,6 +756,108 @@ TEST_F(ValueAccessorFixture, writeString)
     EXPECT_EQ(std::string(reinterpret_cast<const char*>(var.pstrVal), var.strLen), test);
 }
 
+TEST_F(ValueAccessorFixture, writeUtf8AsWide)
+{
+    tVariant var;
+    tVarInit(&var);
+
+    std::string test{"Тест: проверка преобразования 😀"};
+    std::u16string expected{u"Тест: проверка преобразования 😀"};
+
+    EXPECT_THROW(
+        {
+            c12cxx::ValueAccessor v(&var);
+            v.setUtf8AsWide(test);
+        },
+        std::bad_alloc);
+
+    c12cxx::ValueAccessor v(&var, &mem);
+    v.setUtf8AsWide(test);
+
+    EXPECT_EQ(TV_VT(&var), VTYPE_PWSTR);
+    EXPECT_EQ(var.wstrLen, expected.size());
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(var.pwstrVal), var.wstrLen), expected);
+    EXPECT_EQ(var.pwstrVal[var.wstrLen], 0);
+
+    tVarInit(&var);
+    v.setUtf8AsWide("");
+
+    EXPECT_EQ(TV_VT(&var), VTYPE_PWSTR);
+    EXPECT_EQ(var.wstrLen, 0);
+    EXPECT_EQ(var.pwstrVal[0], 0);
+
+    tVarInit(&var);
+    EXPECT_THROW(v.setUtf8AsWide("\xD0x"), std::exception);
+    EXPECT_EQ(TV_VT(&var), VTYPE_EMPTY);
+}
+
+TEST_F(ValueAccessorFixture, stringPolicy)
+{
+    std::u16string wide{u"Тест"};
+    std::string narrow{"Тест"};
+
+    tVariant var;
+    TV_VT(&var) = VTYPE_PWSTR;
+    var.pwstrVal = reinterpret_cast<WCHAR_T*>(wide.data());
+    var.wstrLen = wide.size();
+
+    EXPECT_THROW((void)c12cxx::ValueAccessor(&var, &mem).getValue<std::string>(), std::runtime_error);
+    c12cxx::ValueAccessor utf8(&var, &mem, c12cxx::StringPolicy::Utf8);
+    EXPECT_EQ(utf8.getValue<std::string>(), narrow);
+    EXPECT_EQ(std::get<std::string>(utf8.getValue<c12cxx::Variant>()), narrow);
+    EXPECT_THROW((void)utf8.getValue<std::string_view>(), std::runtime_error);
+
+    utf8.setValue(wide);
+    ASSERT_EQ(TV_VT(&var), VTYPE_PSTR);
+    EXPECT_EQ(std::string(var.pstrVal, var.strLen), narrow);
+
+    EXPECT_THROW((void)c12cxx::ValueAccessor(&var, &mem).getValue<std::u16string>(), std::runtime_error);
+    c12cxx::ValueAccessor utf16(&var, &mem, c12cxx::StringPolicy::Utf16);
+    EXPECT_EQ(utf16.getValue<std::u16string>(), wide);
+    EXPECT_EQ(std::get<std::u16string>(utf16.getValue<c12cxx::Variant>()), wide);
+
+    utf16.setValue(narrow);
+    ASSERT_EQ(TV_VT(&var), VTYPE_PWSTR);
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(var.pwstrVal), var.wstrLen), wide);
+
+    // Output parameters keep the type the host passed.
+    utf8.updateValue(std::string{"Тестирование"});
+    ASSERT_EQ(TV_VT(&var), VTYPE_PWSTR);
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(var.pwstrVal), var.wstrLen), u"Тестирование");
+}
+
+TEST_F(ValueAccessorFixture, writeNumericVector)
+{
+    tVariant var;
+    tVarInit(&var);
+    c12cxx::ValueAccessor v(&var, &mem);
+
+    std::vector<double> test{0.5, -1.0, 1e300};
+    v.setValue(test);
+
+    EXPECT_EQ(TV_VT(&var), VTYPE_BLOB);
+    ASSERT_EQ(var.strLen, test.size() * sizeof(double));
+    EXPECT_EQ(std::memcmp(var.pstrVal, test.data(), var.strLen), 0);
+    EXPECT_EQ(v.getValue<std::vector<double>>(), test);
+
+    char* buffer = var.pstrVal;
+    v.updateValue(std::vector<double>{2.0});
+    EXPECT_EQ(var.pstrVal, buffer);
+    EXPECT_EQ(v.getValue<std::vector<double>>(), std::vector<double>{2.0});
+}
+
+TEST_F(ValueAccessorFixture, numericVectorIsLittleEndian)
+{
+    tVariant var;
+    tVarInit(&var);
+    c12cxx::ValueAccessor v(&var, &mem);
+
+    v.setValue(std::vector<std::uint16_t>{0x0102, 0x0304});
+    ASSERT_EQ(TV_VT(&var), VTYPE_BLOB);
+    EXPECT_EQ(std::vector<char>(var.pstrVal, var.pstrVal + var.strLen), (std::vector<char>{2, 1, 4, 3}));
+    EXPECT_EQ(v.getValue<std::vector<std::uint16_t>>(), (std::vector<std::uint16_t>{0x0102, 0x0304}));
+}
+
 TEST_F(ValueAccessorFixture, writeVector)
 {
     tVariant var;
@@ -0,0 +1,207 @@
+#include <c12cxx/c12cxx.h>
+#include <c12cxx/details/api/ComponentBase.h>
+#include <c12cxx/details/api/types.h>
+
+#include "test_utils.h"
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+bool countAllocations = false;
+size_t allocationCount = 0;
+
+void* countedAlloc(std::size_t size)
+{
+    if (countAllocations)
+        ++allocationCount;
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+// Replacements of the global allocation functions for the whole test binary; they only count while
+// an AllocationCounter is alive.
+void* operator new(std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+
+class AllocationCounter {
+public:
+    AllocationCounter()
+    {
+        allocationCount = 0;
+        countAllocations = true;
+    }
+
+    ~AllocationCounter() { countAllocations = false; }
+
+    AllocationCounter(AllocationCounter const&) = delete;
+    AllocationCounter& operator=(AllocationCounter const&) = delete;
+
+    size_t count() const noexcept { return allocationCount; }
+};
+
+constexpr char16_t kComponentName[] = u"AllocationComponent";
+
+class AllocationComponent final: public c12cxx::Component {
+public:
+    std::u16string componentName() final { return kComponentName; };
+
+    double handler(double first, double second, std::u16string const& str) { return first + second; }
+};
+
+} // namespace
+
+class AllocationFixture: public ::testing::Test {
+protected:
+    TestAddInBase base;
+    TestMemoryManager mem;
+    std::unique_ptr<IComponentBase> ext;
+    AllocationComponent& component() { return *(dynamic_cast<AllocationComponent*>(ext.get())); }
+
+    void SetUp() override
+    {
+        ext.reset(new AllocationComponent);
+        ext->Init(&base);
+        ext->setMemManager(&mem);
+    }
+
+    void TearDown() override
+    {
+        ext.reset();
+        base.Clear();
+        mem.Clear();
+    }
+};
+
+TEST_F(AllocationFixture, lookupDoesNotAllocate)
+{
+    const std::u16string method_name{u"ОбработатьСтрокуТабличнойЧастиЗаказа"};
+    const std::u16string property_name{u"КоличествоОбработанныхСтрокЗаказа"};
+
+    component().addProperty(u"ProcessedOrderLinesCount", property_name).withGetter([]() { return 1; });
+    component().addMethod(u"ProcessOrderTablePartLine", method_name).withHandler([](int a, int b) { return a + b; });
+
+    long method_no = -1;
+    long property_no = -1;
+    long n_params = -1;
+    bool has_ret_val = false;
+
+    size_t allocations = 0;
+    {
+        AllocationCounter counter;
+        method_no = ext->FindMethod(reinterpret_cast<const WCHAR_T*>(method_name.c_str()));
+        property_no = ext->FindProp(reinterpret_cast<const WCHAR_T*>(property_name.c_str()));
+        n_params = ext->GetNParams(method_no);
+        has_ret_val = ext->HasRetVal(method_no);
+        (void)ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"НеизвестныйМетодСДлиннымИменем"));
+        (void)ext->FindProp(reinterpret_cast<const WCHAR_T*>(u"НеизвестноеСвойствоСДлиннымИменем"));
+        allocations = counter.count();
+    }
+
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(method_no, component().methods().size() - 1);
+    EXPECT_EQ(property_no, component().properties().size() - 1);
+    EXPECT_EQ(n_params, 2);
+    EXPECT_TRUE(has_ret_val);
+}
+
+TEST_F(AllocationFixture, callDoesNotAllocate)
+{
+    component().addMethod(u"Sum", u"Сумма").withHandler([](int a, int& b) { return a + b++; });
+    component().addMethod(u"Reset", u"Сбросить").withHandler([]() { });
+
+    tVariant params[2];
+    tVarInit(&params[0]);
+    TV_VT(&params[0]) = VTYPE_I4;
+    params[0].lVal = 1;
+    tVarInit(&params[1]);
+    TV_VT(&params[1]) = VTYPE_I4;
+    params[1].lVal = 2;
+    tVariant ret;
+    tVarInit(&ret);
+
+    bool func_result = false;
+    bool proc_result = false;
+    size_t allocations = 0;
+    {
+        AllocationCounter counter;
+        func_result = ext->CallAsFunc(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"Sum")), &ret, params, 2);
+        proc_result = ext->CallAsProc(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"Reset")), nullptr, 0);
+        allocations = counter.count();
+    }
+
+    EXPECT_EQ(allocations, 0);
+    EXPECT_TRUE(func_result);
+    EXPECT_TRUE(proc_result);
+    EXPECT_EQ(TV_VT(&ret), VTYPE_I4);
+    EXPECT_EQ(ret.lVal, 3);
+    EXPECT_EQ(params[1].lVal, 3);
+}
+
+TEST_F(AllocationFixture, handlerCopyDoesNotAllocate)
+{
+    // Names are kept in the name pool of the table, so any allocation would come from the handlers.
+    auto& method = component().addMethod(u"M", u"М").withHandler(component(), &AllocationComponent::handler);
+    auto& property = component().addProperty(u"P", u"С").withGetter([str = std::u16string()]() { return str; });
+
+    size_t allocations = 0;
+    {
+        AllocationCounter counter;
+        c12cxx::Method method_copy{method};
+        c12cxx::Property property_copy{property};
+        allocations = counter.count();
+    }
+
+    EXPECT_EQ(allocations, 0);
+}
+
+TEST_F(AllocationFixture, counterSeesAllocations)
+{
+    size_t allocations = 0;
+    {
+        AllocationCounter counter;
+        auto str = std::make_unique<std::u16string>(u"Строка, которая не помещается в буфер SSO");
+        allocations = counter.count();
+    }
+
+    EXPECT_GT(allocations, 0);
+}
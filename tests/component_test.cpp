@@ -1,4 +1,5 @@
 #include <c12cxx/c12cxx.h>
+#include <c12cxx/details/Batch.h>
 #include <c12cxx/details/ValueAccessor.h>
 #include <c12cxx/details/api/ComponentBase.h>
 #include <c12cxx/details/api/IMemoryManager.h>
@@ -8,8 +9,11 @@
 #include <ctime>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -58,6 +62,14 @@ public:
             ch = 1;
     }
 
+    c12cxx::HostStringWriter repeat(std::u16string_view str, int count)
+    {
+        c12cxx::HostStringWriter out(memoryManager());
+        for (int i = 0; i < count; ++i)
+            out.append(str);
+        return out;
+    }
+
     int getIntData() const noexcept { return intData; }
 
     void setIntData(int value) noexcept { intData = value; }
@@ -640,6 +652,44 @@ TEST_F(TestComponentFixture, SetPropVal_pair)
     EXPECT_FALSE(component().hasError());
 }
 
+TEST_F(TestComponentFixture, SetPropVal_blobView)
+{
+    std::vector<unsigned char> test{1, 2, 3};
+    c12cxx::BlobView value;
+
+    component().addProperty(u"Test", u"Тест").withSetter([&value](c12cxx::BlobView val) { value = val; });
+
+    tVariant var;
+    TV_VT(&var) = VTYPE_BLOB;
+    var.pstrVal = reinterpret_cast<char*>(test.data());
+    var.strLen = test.size();
+    EXPECT_TRUE(ext->SetPropVal(component().properties().size() - 1, &var));
+    EXPECT_EQ(static_cast<const void*>(value.data()), static_cast<const void*>(test.data()));
+    EXPECT_EQ(value.size(), test.size());
+
+    EXPECT_FALSE(component().hasError());
+}
+
+TEST_F(TestComponentFixture, SetPropVal_invalidUtf8)
+{
+    std::string value{};
+    std::string test_value{"Te\xD0st"};
+
+    component().addProperty(u"Test", u"Тест").withSetter([&value](std::string val) { value = val; });
+
+    tVariant var;
+    TV_VT(&var) = VTYPE_PSTR;
+    var.pstrVal = test_value.data();
+    var.strLen = test_value.size();
+    EXPECT_FALSE(ext->SetPropVal(component().properties().size() - 1, &var));
+    EXPECT_TRUE(value.empty());
+    EXPECT_TRUE(component().hasError());
+
+    component().setUtf8Validation(false);
+    EXPECT_TRUE(ext->SetPropVal(component().properties().size() - 1, &var));
+    EXPECT_EQ(value, test_value);
+}
+
 TEST_F(TestComponentFixture, SetPropVal_error)
 {
     EXPECT_FALSE(component().hasError());
@@ -681,6 +731,68 @@ TEST_F(TestComponentFixture, FindMethod_withKnownName)
     EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(method_alt.data())), component().methods().size() - 1);
 }
 
+TEST_F(TestComponentFixture, FindMethod_withManyMembers)
+{
+    const auto first_no = component().methods().size();
+    constexpr size_t count = 500;
+    for (size_t i = 0; i < count; ++i) {
+        auto suffix = std::to_string(i);
+        component().addMethod(u"Method" + std::u16string(suffix.begin(), suffix.end()),
+                              u"Метод" + std::u16string(suffix.begin(), suffix.end()));
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        auto suffix = std::to_string(i);
+        std::u16string name = u"Method" + std::u16string(suffix.begin(), suffix.end());
+        std::u16string alt = u"Метод" + std::u16string(suffix.begin(), suffix.end());
+        EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(name.c_str())), first_no + i);
+        EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(alt.c_str())), first_no + i);
+    }
+    EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"Method500")), -1);
+}
+
+TEST_F(TestComponentFixture, FindMethod_withDuplicateName)
+{
+    const auto first_no = component().methods().size();
+    component().addMethod(u"Duplicate", u"Дубль");
+    component().addMethod(u"Duplicate", u"Дубль");
+
+    EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"Duplicate")), first_no);
+    EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"Дубль")), first_no);
+}
+
+TEST_F(TestComponentFixture, FindMethod_ignoresCase)
+{
+    component().addMethod(u"ProcessOrder", u"ОбработатьЗаказЁлки");
+    const auto method_no = component().methods().size() - 1;
+
+    EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"processorder")), method_no);
+    EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"PROCESSORDER")), method_no);
+    EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"обработатьзаказёлки")), method_no);
+    EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"ОБРАБОТАТЬЗАКАЗЁЛКИ")), method_no);
+    EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"ОбработатьЗаказЕлки")), -1);
+    EXPECT_EQ(ext->FindProp(reinterpret_cast<const WCHAR_T*>(u"естьошибка")),
+              ext->FindProp(reinterpret_cast<const WCHAR_T*>(u"HASERROR")));
+}
+
+// Including names too long to be folded on the stack.
+TEST_F(TestComponentFixture, FindMethod_ignoresCaseOfLongNames)
+{
+    for (std::size_t size: {8, 64, 65, 200}) {
+        std::u16string name(size, u'Я');
+        std::u16string alt(size, u'z');
+        component().addMethod(name, alt);
+        const long method_no = component().methods().size() - 1;
+
+        std::u16string name_folded(size, u'я');
+        std::u16string alt_upper(size, u'Z');
+        EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(name_folded.c_str())), method_no) << size;
+        EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(alt_upper.c_str())), method_no) << size;
+        name_folded.back() = u'ю';
+        EXPECT_EQ(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(name_folded.c_str())), -1) << size;
+    }
+}
+
 TEST_F(TestComponentFixture, GetMethodName_withUnrealNum)
 {
     const auto unreal_num = std::numeric_limits<long>::max();
@@ -703,6 +815,17 @@ TEST_F(TestComponentFixture, GetMethodName_withCorrectNum)
         std::u16string(reinterpret_cast<const char16_t*>(ext->GetMethodName(component().methods().size() - 1, 1))));
 }
 
+TEST_F(TestComponentFixture, GetMethodName_ofSharedAndOwnMembers)
+{
+    component().addMethod(u"OwnMethod", u"СобственныйМетод");
+
+    const auto own_no = component().methods().size() - 1;
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(ext->GetMethodName(0, 0))), u"ClearError");
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(ext->GetMethodName(0, 1))), u"ОчиститьОшибку");
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(ext->GetMethodName(own_no, 0))), u"OwnMethod");
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(ext->GetMethodName(own_no, 1))), u"СобственныйМетод");
+}
+
 TEST_F(TestComponentFixture, GetNParams_withUnrealNum)
 {
     EXPECT_EQ(ext->GetNParams(std::numeric_limits<long>::max()), 0);
@@ -761,6 +884,121 @@ TEST_F(TestComponentFixture, GetParamDefValue)
     EXPECT_FALSE(component().hasError());
 }
 
+TEST_F(TestComponentFixture, GetParamDefValue_strings)
+{
+    component().addMethod(u"TestMethod", u"ТестовыйМетод").withDefaults({
+        {0, std::u16string(u"Тест")},
+        {1, std::string("Test")},
+        {3, std::vector<unsigned char>{1, 2, 3}},
+    });
+    const long method_no = component().methods().size() - 1;
+
+    tVariant var;
+    tVarInit(&var);
+
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_TRUE(ext->GetParamDefValue(method_no, 0, &var));
+        ASSERT_EQ(TV_VT(&var), VTYPE_PWSTR);
+        EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(var.pwstrVal), var.wstrLen), u"Тест");
+        EXPECT_EQ(var.pwstrVal[var.wstrLen], 0);
+    }
+
+    EXPECT_TRUE(ext->GetParamDefValue(method_no, 1, &var));
+    ASSERT_EQ(TV_VT(&var), VTYPE_PSTR);
+    EXPECT_EQ(std::string(var.pstrVal, var.strLen), "Test");
+    EXPECT_EQ(var.pstrVal[var.strLen], 0);
+
+    EXPECT_FALSE(ext->GetParamDefValue(method_no, 2, &var));
+
+    EXPECT_TRUE(ext->GetParamDefValue(method_no, 3, &var));
+    ASSERT_EQ(TV_VT(&var), VTYPE_BLOB);
+    EXPECT_EQ(std::vector<char>(var.pstrVal, var.pstrVal + var.strLen), (std::vector<char>{1, 2, 3}));
+
+    EXPECT_FALSE(ext->GetParamDefValue(method_no, 4, &var));
+    EXPECT_FALSE(ext->GetParamDefValue(method_no, -1, &var));
+
+    EXPECT_THROW(component().addMethod(u"Invalid", u"Неверный").withDefaults({{-1, true}}), std::invalid_argument);
+}
+
+// String defaults reach the host in the string type of the component's policy.
+TEST_F(TestComponentFixture, GetParamDefValue_stringsUnderStringPolicy)
+{
+    component().addMethod(u"TestMethod", u"ТестовыйМетод").withDefaults({
+        {0, std::u16string(u"Тест")},
+        {1, std::string("Тест")},
+    });
+    const long method_no = component().methods().size() - 1;
+
+    const std::pair<c12cxx::StringPolicy, std::pair<TYPEVAR, TYPEVAR>> cases[] = {
+        {c12cxx::StringPolicy::AsIs, {VTYPE_PWSTR, VTYPE_PSTR}},
+        {c12cxx::StringPolicy::Utf8, {VTYPE_PSTR, VTYPE_PSTR}},
+        {c12cxx::StringPolicy::Utf16, {VTYPE_PWSTR, VTYPE_PWSTR}},
+    };
+    for (auto const& [policy, types]: cases) {
+        component().setStringPolicy(policy);
+        for (long param = 0; param < 2; ++param) {
+            tVariant var;
+            tVarInit(&var);
+            ASSERT_TRUE(ext->GetParamDefValue(method_no, param, &var));
+            ASSERT_EQ(TV_VT(&var), param == 0 ? types.first : types.second) << static_cast<int>(policy);
+            if (TV_VT(&var) == VTYPE_PWSTR) {
+                EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(var.pwstrVal), var.wstrLen), u"Тест");
+                EXPECT_EQ(var.pwstrVal[var.wstrLen], 0);
+            } else {
+                EXPECT_EQ(std::string(var.pstrVal, var.strLen), "Тест");
+                EXPECT_EQ(var.pstrVal[var.strLen], 0);
+            }
+            mem.FreeMemory(reinterpret_cast<void**>(&var.pstrVal));
+        }
+    }
+    EXPECT_FALSE(component().hasError());
+}
+
+TEST_F(TestComponentFixture, GetParamDefValue_optional)
+{
+    component()
+        .addMethod(u"Describe", u"Описать")
+        .withHandler([](int count, std::optional<std::u16string> const& prefix, std::optional<bool> flag) {
+            return prefix.value_or(u"none") + (flag ? (*flag ? u", on" : u", off") : u"") + u" " +
+                   std::u16string(count, u'*');
+        })
+        .withDefaults({{2, true}});
+    const long method_no = component().methods().size() - 1;
+
+    tVariant params[3];
+    tVarInit(&params[0]);
+    TV_VT(&params[0]) = VTYPE_I4;
+    params[0].lVal = 2;
+
+    EXPECT_FALSE(ext->GetParamDefValue(method_no, 0, &params[1]));
+
+    TV_VT(&params[1]) = VTYPE_I4;
+    EXPECT_TRUE(ext->GetParamDefValue(method_no, 1, &params[1]));
+    EXPECT_EQ(TV_VT(&params[1]), VTYPE_EMPTY);
+
+    EXPECT_TRUE(ext->GetParamDefValue(method_no, 2, &params[2]));
+    EXPECT_EQ(TV_VT(&params[2]), VTYPE_BOOL);
+
+    tVariant result;
+    tVarInit(&result);
+    ASSERT_TRUE(ext->CallAsFunc(method_no, &result, params, 3));
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(result.pwstrVal), result.wstrLen), u"none, on **");
+
+    std::u16string prefix{u"some"};
+    TV_VT(&params[1]) = VTYPE_PWSTR;
+    params[1].pwstrVal = reinterpret_cast<WCHAR_T*>(prefix.data());
+    params[1].wstrLen = prefix.size();
+    tVarInit(&params[2]);
+    tVarInit(&result);
+    ASSERT_TRUE(ext->CallAsFunc(method_no, &result, params, 3));
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(result.pwstrVal), result.wstrLen), u"some **");
+
+    TV_VT(&params[2]) = VTYPE_I4;
+    tVarInit(&result);
+    EXPECT_FALSE(ext->CallAsFunc(method_no, &result, params, 3));
+    EXPECT_TRUE(component().hasError());
+}
+
 TEST_F(TestComponentFixture, HasRetValue_withUnrealNum)
 {
     EXPECT_FALSE(ext->HasRetVal(std::numeric_limits<long>::max()));
@@ -855,6 +1093,45 @@ TEST_F(TestComponentFixture, CallAsProc)
     EXPECT_FALSE(component().hasError());
 }
 
+// Output parameters passed by reference are written to the referenced variable, reusing its buffer.
+TEST_F(TestComponentFixture, CallAsProc_outParamsByReference)
+{
+    component().addMethod(u"Update", u"Обновить").withHandler([](int& number, std::u16string& text) {
+        number += 1;
+        text = u"Done";
+    });
+
+    std::u16string buffer{u"Pending"};
+    tVariant referred[2];
+    tVarInit(&referred[0]);
+    TV_VT(&referred[0]) = VTYPE_I2;
+    referred[0].shortVal = 2;
+    tVarInit(&referred[1]);
+    TV_VT(&referred[1]) = VTYPE_PWSTR;
+    referred[1].pwstrVal = reinterpret_cast<WCHAR_T*>(buffer.data());
+    referred[1].wstrLen = buffer.size();
+
+    tVariant params[2];
+    for (int i = 0; i < 2; ++i) {
+        tVarInit(&params[i]);
+        TV_VT(&params[i]) = VTYPE_VARIANT | VTYPE_BYREF;
+        params[i].pvarVal = &referred[i];
+    }
+
+    ASSERT_TRUE(ext->CallAsProc(component().methods().size() - 1, params, 2));
+    EXPECT_FALSE(component().hasError());
+
+    EXPECT_EQ(TV_VT(&params[0]), VTYPE_VARIANT | VTYPE_BYREF);
+    EXPECT_EQ(params[0].pvarVal, &referred[0]);
+    EXPECT_EQ(TV_VT(&referred[0]), VTYPE_I2);
+    EXPECT_EQ(referred[0].shortVal, 3);
+
+    EXPECT_EQ(TV_VT(&params[1]), VTYPE_VARIANT | VTYPE_BYREF);
+    EXPECT_EQ(TV_VT(&referred[1]), VTYPE_PWSTR);
+    EXPECT_EQ(referred[1].pwstrVal, reinterpret_cast<WCHAR_T*>(buffer.data()));
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(referred[1].pwstrVal), referred[1].wstrLen), u"Done");
+}
+
 TEST_F(TestComponentFixture, CallAsFunc_withUnrealNum)
 {
     EXPECT_FALSE(ext->CallAsFunc(std::numeric_limits<long>::max(), nullptr, nullptr, 0));
@@ -898,3 +1175,666 @@ TEST_F(TestComponentFixture, CallAsFunc)
 
     EXPECT_FALSE(component().hasError());
 }
+
+TEST_F(TestComponentFixture, CallAsFunc_utf8StringPolicy)
+{
+    component().setStringPolicy(c12cxx::StringPolicy::Utf8);
+    component().addMethod(u"TestMethod", u"ТестовыйМетод").withHandler([](std::string& str) -> std::string {
+        auto ret = str;
+        str += "!";
+        return ret;
+    });
+
+    std::u16string test{u"Тест"};
+
+    tVariant param;
+    TV_VT(&param) = VTYPE_PWSTR;
+    param.pwstrVal = reinterpret_cast<WCHAR_T*>(test.data());
+    param.wstrLen = test.size();
+
+    tVariant result;
+
+    EXPECT_TRUE(ext->CallAsFunc(component().methods().size() - 1, &result, &param, 1));
+
+    ASSERT_EQ(TV_VT(&result), VTYPE_PSTR);
+    EXPECT_EQ(std::string(result.pstrVal, result.strLen), "Тест");
+    ASSERT_EQ(TV_VT(&param), VTYPE_PWSTR);
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(param.pwstrVal), param.wstrLen), u"Тест!");
+
+    EXPECT_FALSE(component().hasError());
+}
+
+TEST_F(TestComponentFixture, CallAsFunc_utf16StringPolicy)
+{
+    component().setStringPolicy(c12cxx::StringPolicy::Utf16);
+    component().addMethod(u"TestMethod", u"ТестовыйМетод").withHandler([](std::u16string const& str) -> std::string {
+        return str == u"Тест" ? "Ответ" : "";
+    });
+
+    std::string test{"Тест"};
+
+    tVariant param;
+    TV_VT(&param) = VTYPE_PSTR;
+    param.pstrVal = test.data();
+    param.strLen = test.size();
+
+    tVariant result;
+
+    EXPECT_TRUE(ext->CallAsFunc(component().methods().size() - 1, &result, &param, 1));
+
+    ASSERT_EQ(TV_VT(&result), VTYPE_PWSTR);
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(result.pwstrVal), result.wstrLen), u"Ответ");
+
+    EXPECT_FALSE(component().hasError());
+}
+
+// A string the policy transcodes is routed to an overload taking the other string type if none takes it as is.
+TEST_F(TestComponentFixture, CallAsFunc_overloadsWithStringPolicy)
+{
+    component().setStringPolicy(c12cxx::StringPolicy::Utf8);
+    auto& method = component()
+                       .addMethod(u"Describe", u"Описать")
+                       .withOverload([](int value) -> std::string { return "int"; })
+                       .withOverload([](std::string const& value) -> std::string { return "string: " + value; });
+    const long method_no = component().methods().size() - 1;
+
+    std::u16string test{u"Тест"};
+    tVariant param;
+    tVarInit(&param);
+    TV_VT(&param) = VTYPE_PWSTR;
+    param.pwstrVal = reinterpret_cast<WCHAR_T*>(test.data());
+    param.wstrLen = test.size();
+    tVariant result;
+    tVarInit(&result);
+
+    ASSERT_TRUE(ext->CallAsFunc(method_no, &result, &param, 1));
+    ASSERT_EQ(TV_VT(&result), VTYPE_PSTR);
+    EXPECT_EQ(std::string(result.pstrVal, result.strLen), "string: Тест");
+    mem.FreeMemory(reinterpret_cast<void**>(&result.pstrVal));
+
+    method.withOverload([](std::u16string const& value) -> std::string { return "u16string"; });
+    tVarInit(&result);
+    ASSERT_TRUE(ext->CallAsFunc(method_no, &result, &param, 1));
+    ASSERT_EQ(TV_VT(&result), VTYPE_PSTR);
+    EXPECT_EQ(std::string(result.pstrVal, result.strLen), "u16string");
+    EXPECT_FALSE(component().hasError());
+}
+
+TEST_F(TestComponentFixture, CallAsFunc_hostWriter)
+{
+    component().addMethod(u"Repeat", u"Повторить").withHandler(component(), &TestComponent::repeat);
+
+    std::u16string test{u"Тест"};
+    tVariant params[2];
+    tVarInit(&params[0]);
+    TV_VT(&params[0]) = VTYPE_PWSTR;
+    params[0].pwstrVal = reinterpret_cast<WCHAR_T*>(test.data());
+    params[0].wstrLen = test.size();
+    tVarInit(&params[1]);
+    TV_VT(&params[1]) = VTYPE_I4;
+    params[1].lVal = 1000;
+
+    tVariant result;
+    tVarInit(&result);
+    EXPECT_TRUE(ext->CallAsFunc(component().methods().size() - 1, &result, params, 2));
+
+    ASSERT_EQ(TV_VT(&result), VTYPE_PWSTR);
+    ASSERT_EQ(result.wstrLen, test.size() * 1000);
+    EXPECT_EQ(result.pwstrVal[result.wstrLen], 0);
+    EXPECT_TRUE(std::equal(test.begin(), test.end(), result.pwstrVal + test.size() * 999));
+    EXPECT_FALSE(component().hasError());
+}
+
+TEST_F(TestComponentFixture, CallAsFunc_withOverloads)
+{
+    component()
+        .addMethod(u"Describe", u"Описать")
+        .withOverload([](int value) -> std::u16string { return u"int"; })
+        .withOverload([](std::u16string const& value) -> std::u16string { return u"string"; })
+        .withOverload([](std::u16string const& value, bool flag) -> std::u16string { return u"string, bool"; });
+    const long method_no = component().methods().size() - 1;
+
+    EXPECT_EQ(ext->GetNParams(method_no), 2);
+    EXPECT_TRUE(ext->HasRetVal(method_no));
+
+    std::u16string test{u"Test"};
+    tVariant params[2];
+    tVariant result;
+
+    auto call = [&]() -> std::u16string {
+        tVarInit(&result);
+        if (!ext->CallAsFunc(method_no, &result, params, 2))
+            return u"<error>";
+        return std::u16string(reinterpret_cast<const char16_t*>(result.pwstrVal), result.wstrLen);
+    };
+
+    tVarInit(&params[0]);
+    TV_VT(&params[0]) = VTYPE_I4;
+    params[0].lVal = 1;
+    tVarInit(&params[1]);
+    EXPECT_EQ(call(), u"int");
+
+    TV_VT(&params[0]) = VTYPE_PWSTR;
+    params[0].pwstrVal = reinterpret_cast<WCHAR_T*>(test.data());
+    params[0].wstrLen = test.size();
+    EXPECT_EQ(call(), u"string");
+
+    TV_VT(&params[1]) = VTYPE_BOOL;
+    params[1].bVal = true;
+    EXPECT_EQ(call(), u"string, bool");
+    EXPECT_FALSE(component().hasError());
+
+    TV_VT(&params[0]) = VTYPE_BOOL;
+    EXPECT_EQ(call(), u"<error>");
+    EXPECT_TRUE(component().hasError());
+}
+
+// The host completes a call with fewer arguments by the default values of the omitted parameters.
+TEST_F(TestComponentFixture, CallAsFunc_withOverloadsAndOmittedArguments)
+{
+    component()
+        .addMethod(u"Describe", u"Описать")
+        .withOverload([](int value) -> std::u16string { return u"int"; })
+        .withOverload([](std::u16string const& value) -> std::u16string { return u"string"; })
+        .withOverload([](std::u16string const& value, bool flag) -> std::u16string { return u"string, bool"; });
+    const long method_no = component().methods().size() - 1;
+
+    const long n_params = ext->GetNParams(method_no);
+    ASSERT_EQ(n_params, 2);
+    EXPECT_FALSE(ext->GetParamDefValue(method_no, 0, nullptr));
+
+    std::vector<tVariant> params(n_params);
+    tVarInit(&params[0]);
+    TV_VT(&params[0]) = VTYPE_I4;
+    params[0].lVal = 1;
+    ASSERT_TRUE(ext->GetParamDefValue(method_no, 1, &params[1]));
+    EXPECT_EQ(TV_VT(&params[1]), VTYPE_EMPTY);
+
+    tVariant result;
+    tVarInit(&result);
+    ASSERT_TRUE(ext->CallAsFunc(method_no, &result, params.data(), n_params));
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(result.pwstrVal), result.wstrLen), u"int");
+    EXPECT_FALSE(component().hasError());
+}
+
+TEST_F(TestComponentFixture, CallAsFunc_variantParam)
+{
+    component().addMethod(u"Describe", u"Описать").withHandler([](c12cxx::Variant const& value) -> std::u16string {
+        return std::visit(
+            [](auto const& alternative) -> std::u16string {
+                using T = std::decay_t<decltype(alternative)>;
+                if constexpr (std::is_same_v<T, std::monostate>)
+                    return u"undefined";
+                else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, std::int64_t>)
+                    return u"integer";
+                else if constexpr (std::is_same_v<T, std::u16string>)
+                    return alternative;
+                else
+                    return u"other";
+            },
+            value);
+    });
+    const long method_no = component().methods().size() - 1;
+
+    std::u16string test{u"Test"};
+    tVariant referred;
+    tVariant param;
+    tVariant result;
+
+    auto call = [&]() -> std::u16string {
+        tVarInit(&result);
+        if (!ext->CallAsFunc(method_no, &result, &param, 1))
+            return u"<error>";
+        return std::u16string(reinterpret_cast<const char16_t*>(result.pwstrVal), result.wstrLen);
+    };
+
+    tVarInit(&param);
+    EXPECT_EQ(call(), u"undefined");
+
+    TV_VT(&param) = VTYPE_I8;
+    param.llVal = 1;
+    EXPECT_EQ(call(), u"integer");
+
+    tVarInit(&referred);
+    TV_VT(&referred) = VTYPE_PWSTR;
+    referred.pwstrVal = reinterpret_cast<WCHAR_T*>(test.data());
+    referred.wstrLen = test.size();
+    tVarInit(&param);
+    TV_VT(&param) = VTYPE_VARIANT | VTYPE_BYREF;
+    param.pvarVal = &referred;
+    EXPECT_EQ(call(), u"Test");
+    EXPECT_FALSE(component().hasError());
+}
+
+TEST_F(TestComponentFixture, CallAsFunc_variadic)
+{
+    component().addMethod(u"Sum", u"Сумма").withVariadicHandler(
+        [](std::vector<c12cxx::Variant> const& values) {
+            double sum = 0;
+            for (auto const& value: values) {
+                if (auto const* number = std::get_if<int>(&value))
+                    sum += *number;
+                else if (auto const* real = std::get_if<double>(&value))
+                    sum += *real;
+                else if (!std::holds_alternative<std::monostate>(value))
+                    throw std::invalid_argument("Number expected.");
+            }
+            return sum;
+        },
+        20);
+    const long sum_no = component().methods().size() - 1;
+
+    component().addMethod(u"Count", u"Количество").withVariadicHandler(
+        [](c12cxx::ParamSpan const& params) { return static_cast<int>(params.size()); }, 20);
+    const long count_no = component().methods().size() - 1;
+
+    EXPECT_EQ(ext->GetNParams(sum_no), 20);
+    EXPECT_TRUE(ext->HasRetVal(sum_no));
+
+    tVariant params[20];
+    for (long i = 0; i < 20; ++i)
+        EXPECT_TRUE(ext->GetParamDefValue(sum_no, i, &params[i]));
+    EXPECT_FALSE(ext->GetParamDefValue(sum_no, 20, &params[0]));
+
+    TV_VT(&params[0]) = VTYPE_I4;
+    params[0].lVal = 1;
+    TV_VT(&params[2]) = VTYPE_R8;
+    params[2].dblVal = 0.5;
+
+    tVariant result;
+    tVarInit(&result);
+    ASSERT_TRUE(ext->CallAsFunc(sum_no, &result, params, 20));
+    EXPECT_EQ(TV_VT(&result), VTYPE_R8);
+    EXPECT_EQ(result.dblVal, 1.5);
+
+    tVarInit(&result);
+    ASSERT_TRUE(ext->CallAsFunc(count_no, &result, params, 20));
+    EXPECT_EQ(result.lVal, 3);
+
+    tVarInit(&result);
+    ASSERT_TRUE(ext->CallAsFunc(count_no, &result, params, 0));
+    EXPECT_EQ(result.lVal, 0);
+    EXPECT_FALSE(component().hasError());
+
+    // Only a call padded to the maximum is trimmed; a shorter one is passed as is, trailing Undefined included.
+    tVarInit(&result);
+    ASSERT_TRUE(ext->CallAsFunc(count_no, &result, params, 5));
+    EXPECT_EQ(result.lVal, 5);
+
+    TV_VT(&params[1]) = VTYPE_BOOL;
+    tVarInit(&result);
+    EXPECT_FALSE(ext->CallAsFunc(sum_no, &result, params, 20));
+    EXPECT_TRUE(component().hasError());
+}
+
+TEST_F(TestComponentFixture, withOverload_ambiguous)
+{
+    auto& method = component().addMethod(u"Describe", u"Описать").withOverload([](int value) { });
+
+    EXPECT_THROW(method.withOverload([](double value) { }), std::logic_error);
+    EXPECT_THROW(method.withOverload([](int value) -> bool { return true; }), std::logic_error);
+    EXPECT_NO_THROW(method.withOverload([](int value, int other) { }));
+    EXPECT_EQ(method.numberOfParams(), 2);
+}
+
+TEST_F(TestComponentFixture, withOverload_afterHandler)
+{
+    auto& method = component().addMethod(u"Describe", u"Описать").withHandler([](int value) { });
+    EXPECT_THROW(method.withOverload([](std::u16string const& value) { }), std::logic_error);
+    EXPECT_EQ(method.numberOfParams(), 1);
+
+    auto& variadic = component().addMethod(u"Sum", u"Сумма").withVariadicHandler([](c12cxx::ParamSpan const&) { }, 3);
+    EXPECT_THROW(variadic.withOverload([](int value) { }), std::logic_error);
+    EXPECT_EQ(variadic.numberOfParams(), 3);
+}
+
+TEST_F(TestComponentFixture, CallBatch)
+{
+    component().addMethod(u"Sum", u"Сумма").withHandler([](int a, int b) { return a + b; });
+    component().addMethod(u"Greet", u"Поприветствовать").withHandler([](std::u16string const& name) {
+        return u"Hello, " + name;
+    });
+    int counter = 0;
+    component().addMethod(u"Increment", u"Увеличить").withHandler([&counter]() { ++counter; });
+
+    const long batch_no = ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"ВыполнитьПакет"));
+    ASSERT_GE(batch_no, 0);
+    EXPECT_TRUE(ext->HasRetVal(batch_no));
+    EXPECT_EQ(ext->GetNParams(batch_no), 1);
+
+    c12cxx::BatchWriter batch;
+    batch.writeCount(5);
+    batch.writeString(std::u16string_view{u"сумма"});
+    batch.writeCount(2);
+    batch.writeInt(2);
+    batch.writeInt(3);
+    batch.writeInt(static_cast<int32_t>(ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"Greet"))));
+    batch.writeCount(1);
+    batch.writeString(std::u16string_view{u"World"});
+    batch.writeString(std::u16string_view{u"Increment"});
+    batch.writeCount(0);
+    batch.writeString(std::u16string_view{u"Unknown"});
+    batch.writeCount(0);
+    batch.writeString(std::u16string_view{u"Sum"});
+    batch.writeCount(2);
+    batch.writeInt(1);
+    batch.writeString(std::u16string_view{u"not a number"});
+
+    tVariant param;
+    tVarInit(&param);
+    TV_VT(&param) = VTYPE_BLOB;
+    param.pstrVal = const_cast<char*>(batch.data().data());
+    param.strLen = batch.data().size();
+    tVariant result;
+    tVarInit(&result);
+
+    ASSERT_TRUE(ext->CallAsFunc(batch_no, &result, &param, 1));
+    EXPECT_FALSE(component().hasError());
+    ASSERT_EQ(TV_VT(&result), VTYPE_BLOB);
+    EXPECT_EQ(counter, 1);
+
+    c12cxx::BatchReader reader(result.pstrVal, result.pstrVal + result.strLen);
+    ASSERT_EQ(reader.readCount(), 5);
+    tVariant value;
+
+    EXPECT_TRUE(reader.readStatus());
+    reader.readValue(value, &mem);
+    EXPECT_EQ(TV_VT(&value), VTYPE_I4);
+    EXPECT_EQ(value.lVal, 5);
+
+    EXPECT_TRUE(reader.readStatus());
+    reader.readValue(value, &mem);
+    ASSERT_EQ(TV_VT(&value), VTYPE_PWSTR);
+    EXPECT_EQ(std::u16string(reinterpret_cast<const char16_t*>(value.pwstrVal), value.wstrLen), u"Hello, World");
+
+    EXPECT_TRUE(reader.readStatus());
+    reader.readValue(value, &mem);
+    EXPECT_EQ(TV_VT(&value), VTYPE_EMPTY);
+
+    EXPECT_FALSE(reader.readStatus());
+    reader.readValue(value, &mem);
+    EXPECT_EQ(TV_VT(&value), VTYPE_PWSTR);
+
+    EXPECT_FALSE(reader.readStatus());
+    reader.readValue(value, &mem);
+    EXPECT_EQ(TV_VT(&value), VTYPE_PWSTR);
+
+    EXPECT_TRUE(reader.atEnd());
+}
+
+TEST_F(TestComponentFixture, CallBatch_numericTypes)
+{
+    component().addMethod(u"Twice", u"Удвоить").withHandler([](std::int64_t value) { return value * 2; });
+    component().addMethod(u"Half", u"Половина").withHandler([](float value) { return value / 2; });
+    const long batch_no = ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"CallBatch"));
+
+    tVariant arg;
+    tVarInit(&arg);
+    c12cxx::BatchWriter batch;
+    batch.writeCount(2);
+    batch.writeString(std::u16string_view{u"Twice"});
+    batch.writeCount(1);
+    TV_VT(&arg) = VTYPE_I8;
+    arg.llVal = 5'000'000'000;
+    batch.writeValue(arg);
+    batch.writeString(std::u16string_view{u"Half"});
+    batch.writeCount(1);
+    TV_VT(&arg) = VTYPE_R4;
+    arg.fltVal = 1.5f;
+    batch.writeValue(arg);
+
+    tVariant param;
+    tVarInit(&param);
+    TV_VT(&param) = VTYPE_BLOB;
+    param.pstrVal = const_cast<char*>(batch.data().data());
+    param.strLen = batch.data().size();
+    tVariant result;
+    tVarInit(&result);
+
+    ASSERT_TRUE(ext->CallAsFunc(batch_no, &result, &param, 1));
+    ASSERT_EQ(TV_VT(&result), VTYPE_BLOB);
+
+    c12cxx::BatchReader reader(result.pstrVal, result.pstrVal + result.strLen);
+    ASSERT_EQ(reader.readCount(), 2);
+    tVariant value;
+
+    EXPECT_TRUE(reader.readStatus());
+    reader.readValue(value, &mem);
+    EXPECT_EQ(TV_VT(&value), VTYPE_I8);
+    EXPECT_EQ(value.llVal, 10'000'000'000);
+
+    EXPECT_TRUE(reader.readStatus());
+    reader.readValue(value, &mem);
+    EXPECT_EQ(TV_VT(&value), VTYPE_R4);
+    EXPECT_EQ(value.fltVal, 0.75f);
+
+    EXPECT_TRUE(reader.atEnd());
+}
+
+TEST_F(TestComponentFixture, CallBatch_isLittleEndian)
+{
+    c12cxx::BatchWriter batch;
+    batch.writeInt(0x01020304);
+    EXPECT_EQ(batch.data(), (std::vector<char>{VTYPE_I4, 0, 4, 3, 2, 1}));
+}
+
+TEST_F(TestComponentFixture, CallBatch_malformed)
+{
+    const long batch_no = ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"CallBatch"));
+
+    c12cxx::BatchWriter batch;
+    batch.writeCount(2);
+    batch.writeString(std::u16string_view{u"ClearError"});
+    batch.writeCount(0);
+
+    tVariant param;
+    tVarInit(&param);
+    TV_VT(&param) = VTYPE_BLOB;
+    param.pstrVal = const_cast<char*>(batch.data().data());
+    param.strLen = batch.data().size();
+    tVariant result;
+    tVarInit(&result);
+
+    EXPECT_FALSE(ext->CallAsFunc(batch_no, &result, &param, 1));
+    EXPECT_TRUE(component().hasError());
+}
+
+// An argument count the rest of the input cannot hold is rejected before anything is allocated for it.
+TEST_F(TestComponentFixture, CallBatch_argumentCountBeyondInput)
+{
+    const long batch_no = ext->FindMethod(reinterpret_cast<const WCHAR_T*>(u"CallBatch"));
+
+    c12cxx::BatchWriter batch;
+    batch.writeCount(1);
+    batch.writeString(std::u16string_view{u"ClearError"});
+    batch.writeCount(0xFFFFFFFF);
+    batch.writeEmpty();
+
+    tVariant param;
+    tVarInit(&param);
+    TV_VT(&param) = VTYPE_BLOB;
+    param.pstrVal = const_cast<char*>(batch.data().data());
+    param.strLen = batch.data().size();
+    tVariant result;
+    tVarInit(&result);
+
+    EXPECT_FALSE(ext->CallAsFunc(batch_no, &result, &param, 1));
+    EXPECT_TRUE(component().hasError());
+}
+
+namespace {
+
+class TypedTestComponent final: public c12cxx::TypedComponent<TypedTestComponent> {
+public:
+    std::u16string componentName() final { return u"TypedTestComponent"; };
+
+    static void describe(c12cxx::MemberTable& members)
+    {
+        members.addProperty(u"Counter", u"Счетчик")
+            .withGetter(&TypedTestComponent::counter)
+            .withSetter(&TypedTestComponent::setCounter);
+        members.addMethod(u"Increment", u"Увеличить").withHandler(&TypedTestComponent::increment);
+    }
+
+    int counter() const noexcept { return counter_; }
+
+    void setCounter(int value) noexcept { counter_ = value; }
+
+    int increment(int step)
+    {
+        counter_ += step;
+        return counter_;
+    }
+
+private:
+    int counter_{};
+};
+
+} // namespace
+
+TEST(TypedComponent, sharesMembersBetweenInstances)
+{
+    TypedTestComponent first;
+    TypedTestComponent second;
+
+    EXPECT_EQ(&first.properties()[0], &second.properties()[0]);
+    EXPECT_EQ(&first.methods()[0], &second.methods()[0]);
+    EXPECT_EQ(first.properties().size(), c12cxx::Component::baseMembers().properties().size() + 1);
+    EXPECT_EQ(first.methods().size(), c12cxx::Component::baseMembers().methods().size() + 1);
+
+    first.addMethod(u"Own", u"Собственный");
+    EXPECT_EQ(first.methods().size(), second.methods().size() + 1);
+    EXPECT_EQ(first.FindMethod(reinterpret_cast<const WCHAR_T*>(u"Own")), first.methods().size() - 1);
+    EXPECT_EQ(second.FindMethod(reinterpret_cast<const WCHAR_T*>(u"Own")), -1);
+}
+
+TEST(TypedComponent, dispatchesToInstance)
+{
+    TestMemoryManager mem;
+    TypedTestComponent first;
+    TypedTestComponent second;
+    first.setMemManager(&mem);
+    second.setMemManager(&mem);
+
+    const long prop_no = first.FindProp(reinterpret_cast<const WCHAR_T*>(u"Счетчик"));
+    const long method_no = first.FindMethod(reinterpret_cast<const WCHAR_T*>(u"Increment"));
+    ASSERT_GE(prop_no, 0);
+    ASSERT_GE(method_no, 0);
+    EXPECT_EQ(first.GetNParams(method_no), 1);
+    EXPECT_TRUE(first.HasRetVal(method_no));
+
+    tVariant var;
+    TV_VT(&var) = VTYPE_I4;
+    var.lVal = 10;
+    EXPECT_TRUE(first.SetPropVal(prop_no, &var));
+
+    tVariant param;
+    TV_VT(&param) = VTYPE_I4;
+    param.lVal = 5;
+    tVariant ret;
+    EXPECT_TRUE(second.CallAsFunc(method_no, &ret, &param, 1));
+    EXPECT_EQ(ret.lVal, 5);
+
+    EXPECT_TRUE(first.GetPropVal(prop_no, &var));
+    EXPECT_EQ(var.lVal, 10);
+    EXPECT_EQ(first.counter(), 10);
+    EXPECT_EQ(second.counter(), 5);
+
+    EXPECT_FALSE(first.hasError());
+    EXPECT_FALSE(second.hasError());
+}
+
+namespace {
+
+class StaticTestComponent final: public c12cxx::TypedComponent<StaticTestComponent> {
+public:
+    std::u16string componentName() final { return u"StaticTestComponent"; };
+
+    static constexpr auto members()
+    {
+        return c12cxx::members(
+            c12cxx::method<&StaticTestComponent::add>(u"Add", u"Сложить"),
+            c12cxx::property<&StaticTestComponent::total, &StaticTestComponent::setTotal>(u"Total", u"Итог"),
+            c12cxx::method<&StaticTestComponent::reset>(u"Reset", u"Сбросить"),
+            c12cxx::property<&StaticTestComponent::total>(u"ReadOnlyTotal", u"ИтогТолькоЧтение"));
+    }
+
+    static void describe(c12cxx::MemberTable& members)
+    {
+        members.addMethod(u"Twice", u"Дважды").withHandler(&StaticTestComponent::twice);
+    }
+
+    double add(double value)
+    {
+        total_ += value;
+        return total_;
+    }
+
+    void reset() { total_ = 0; }
+
+    double total() const noexcept { return total_; }
+
+    void setTotal(double value) noexcept { total_ = value; }
+
+    double twice(double value) { return value * 2; }
+
+private:
+    double total_{};
+};
+
+} // namespace
+
+TEST(StaticMembers, registersAndDispatches)
+{
+    TestMemoryManager mem;
+    StaticTestComponent component;
+    component.setMemManager(&mem);
+
+    const long add_no = component.FindMethod(reinterpret_cast<const WCHAR_T*>(u"Сложить"));
+    const long reset_no = component.FindMethod(reinterpret_cast<const WCHAR_T*>(u"Reset"));
+    const long twice_no = component.FindMethod(reinterpret_cast<const WCHAR_T*>(u"Twice"));
+    const long total_no = component.FindProp(reinterpret_cast<const WCHAR_T*>(u"Total"));
+    const long read_only_no = component.FindProp(reinterpret_cast<const WCHAR_T*>(u"ReadOnlyTotal"));
+    ASSERT_GE(add_no, 0);
+    ASSERT_GE(reset_no, 0);
+    ASSERT_GE(twice_no, 0);
+    ASSERT_GE(total_no, 0);
+    ASSERT_GE(read_only_no, 0);
+
+    EXPECT_EQ(component.GetNParams(add_no), 1);
+    EXPECT_TRUE(component.HasRetVal(add_no));
+    EXPECT_EQ(component.GetNParams(reset_no), 0);
+    EXPECT_FALSE(component.HasRetVal(reset_no));
+    EXPECT_TRUE(component.IsPropReadable(total_no));
+    EXPECT_TRUE(component.IsPropWritable(total_no));
+    EXPECT_TRUE(component.IsPropReadable(read_only_no));
+    EXPECT_FALSE(component.IsPropWritable(read_only_no));
+
+    tVariant param;
+    TV_VT(&param) = VTYPE_R8;
+    param.dblVal = 2.5;
+    tVariant ret;
+    EXPECT_TRUE(component.CallAsFunc(add_no, &ret, &param, 1));
+    EXPECT_EQ(ret.dblVal, 2.5);
+    EXPECT_TRUE(component.CallAsFunc(add_no, &ret, &param, 1));
+    EXPECT_EQ(ret.dblVal, 5.0);
+
+    tVariant var;
+    EXPECT_TRUE(component.GetPropVal(read_only_no, &var));
+    EXPECT_EQ(TV_VT(&var), VTYPE_R8);
+    EXPECT_EQ(var.dblVal, 5.0);
+
+    TV_VT(&var) = VTYPE_R8;
+    var.dblVal = 10.0;
+    EXPECT_TRUE(component.SetPropVal(total_no, &var));
+    EXPECT_FALSE(component.SetPropVal(read_only_no, &var));
+    EXPECT_EQ(component.total(), 10.0);
+
+    EXPECT_TRUE(component.CallAsFunc(twice_no, &ret, &param, 1));
+    EXPECT_EQ(ret.dblVal, 5.0);
+
+    EXPECT_TRUE(component.CallAsProc(reset_no, nullptr, 0));
+    EXPECT_EQ(component.total(), 0.0);
+
+    EXPECT_FALSE(component.hasError());
+}
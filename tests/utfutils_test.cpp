@@ -0,0 +1,159 @@
+#include <c12cxx/details/utfutils.h>
+
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// The same characters in both encodings: ASCII, two-, three- and four-byte sequences.
+const std::vector<std::pair<std::string, std::u16string>> kPieces = {
+    {"a", u"a"},
+    {" ", u" "},
+    {"Ж", u"Ж"},
+    {"я", u"я"},
+    {"€", u"€"},
+    {"😀", u"😀"},
+};
+
+// Text of the given length built from a pseudo-random mix of pieces; the seed changes the mix.
+std::pair<std::string, std::u16string> makeText(std::size_t pieces, unsigned seed)
+{
+    std::pair<std::string, std::u16string> text;
+    for (std::size_t i = 0; i < pieces; ++i) {
+        seed = seed * 1103515245 + 12345;
+        // Mostly Cyrillic and ASCII, as in typical messages.
+        const unsigned roll = (seed >> 16) % 16;
+        const std::size_t piece = roll < 6 ? 2 + roll % 2 : roll < 12 ? roll % 2 : 4 + roll % 2;
+        text.first += kPieces[piece].first;
+        text.second += kPieces[piece].second;
+    }
+    return text;
+}
+
+} // namespace
+
+TEST(utfutils, emptyStrings)
+{
+    EXPECT_EQ(c12cxx::toUtf16(""), u"");
+    EXPECT_EQ(c12cxx::toUtf8(u""), "");
+}
+
+TEST(utfutils, transcodesMixedText)
+{
+    for (std::size_t pieces = 0; pieces < 150; ++pieces) {
+        for (unsigned seed = 0; seed < 4; ++seed) {
+            auto const [utf8, utf16] = makeText(pieces, seed);
+            EXPECT_EQ(c12cxx::toUtf16(utf8), utf16) << "pieces = " << pieces << ", seed = " << seed;
+            EXPECT_EQ(c12cxx::toUtf8(utf16), utf8) << "pieces = " << pieces << ", seed = " << seed;
+        }
+    }
+}
+
+TEST(utfutils, transcodesUniformRuns)
+{
+    for (auto const& [utf8, utf16]: kPieces) {
+        std::string longUtf8;
+        std::u16string longUtf16;
+        for (int i = 0; i < 100; ++i) {
+            longUtf8 += utf8;
+            longUtf16 += utf16;
+            EXPECT_EQ(c12cxx::toUtf16(longUtf8), longUtf16);
+            EXPECT_EQ(c12cxx::toUtf8(longUtf16), longUtf8);
+        }
+
+        // The results are allocated for their length, not for the worst case.
+        EXPECT_LT(c12cxx::toUtf16(longUtf8).capacity(), longUtf16.size() + 16);
+        EXPECT_LT(c12cxx::toUtf8(longUtf16).capacity(), longUtf8.size() + 16);
+    }
+}
+
+TEST(utfutils, transcodesIntoExactBuffer)
+{
+    for (std::size_t pieces = 0; pieces < 150; ++pieces) {
+        auto const [utf8, utf16] = makeText(pieces, 1);
+        ASSERT_EQ(c12cxx::utf16Length(utf8), utf16.size()) << "pieces = " << pieces;
+
+        // The buffer is exactly as long as the result, so writing past it is caught by the comparison.
+        std::u16string buffer(utf16.size() + 1, u'#');
+        EXPECT_EQ(c12cxx::toUtf16(utf8, buffer.data(), utf16.size()), utf16.size());
+        EXPECT_EQ(buffer, utf16 + u'#') << "pieces = " << pieces;
+    }
+}
+
+TEST(utfutils, rejectsMalformedUtf8)
+{
+    const std::string padding(40, 'x');
+    const std::string cyrillic = makeText(40, 0).first;
+    for (std::string const bad: {"\xC0\x80", "\xC1\xBF", "\xD0", "\xD0x", "\xE0\x80\x80", "\xED\xA0\x80",
+                                 "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\x80", "\xFF"}) {
+        EXPECT_THROW(c12cxx::toUtf16(bad), std::exception);
+        EXPECT_THROW(c12cxx::toUtf16(padding + bad + padding), std::exception);
+        EXPECT_THROW(c12cxx::toUtf16(cyrillic + bad + cyrillic), std::exception);
+        EXPECT_FALSE(c12cxx::isValidUtf8(padding + bad));
+        EXPECT_FALSE(c12cxx::isValidUtf8(cyrillic + bad + cyrillic));
+
+        const std::string text = cyrillic + bad + cyrillic;
+        std::u16string buffer(c12cxx::utf16Length(text), u'\0');
+        EXPECT_THROW(c12cxx::toUtf16(text, buffer.data(), buffer.size()), std::exception);
+    }
+}
+
+TEST(utfutils, validatesMixedText)
+{
+    for (std::size_t pieces = 0; pieces < 150; ++pieces)
+        EXPECT_TRUE(c12cxx::isValidUtf8(makeText(pieces, 2).first)) << "pieces = " << pieces;
+}
+
+// Every two-byte and many three-byte combinations, placed across the boundary of vector blocks, are accepted by the
+// validator exactly when the transcoder accepts them.
+TEST(utfutils, validatesLikeTranscoder)
+{
+    auto const check = [](std::string const& text) {
+        bool transcodes = true;
+        try {
+            c12cxx::toUtf16(text);
+        } catch (std::exception const&) {
+            transcodes = false;
+        }
+        EXPECT_EQ(c12cxx::isValidUtf8(text), transcodes) << ::testing::PrintToString(text);
+    };
+
+    for (unsigned first = 0x80; first < 0x100; ++first) {
+        for (unsigned second = 0; second < 0x100; ++second) {
+            std::string text(64, 'x');
+            text[31] = static_cast<char>(first);
+            text[32] = static_cast<char>(second);
+            check(text);
+        }
+    }
+
+    for (unsigned lead: {0xE0, 0xE1, 0xED, 0xEF, 0xF0, 0xF4, 0xF5}) {
+        for (unsigned second = 0x70; second < 0xD0; ++second) {
+            for (unsigned third = 0x70; third < 0xD0; ++third) {
+                std::string text(64, 'x');
+                text[30] = static_cast<char>(lead);
+                text[31] = static_cast<char>(second);
+                text[32] = static_cast<char>(third);
+                if (lead >= 0xF0)
+                    text[33] = '\x80';
+                check(text);
+            }
+        }
+    }
+}
+
+TEST(utfutils, rejectsMalformedUtf16)
+{
+    const std::u16string padding(40, u'x');
+    const std::u16string cyrillic = makeText(40, 0).second;
+    for (std::u16string const bad: {u"\xD800", u"\xDC00", u"\xD800x", u"\xDBFF\xDBFF"}) {
+        EXPECT_THROW(c12cxx::toUtf8(bad), std::exception);
+        EXPECT_THROW(c12cxx::toUtf8(padding + bad + padding), std::exception);
+        EXPECT_THROW(c12cxx::toUtf8(cyrillic + bad + cyrillic), std::exception);
+    }
+}